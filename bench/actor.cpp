@@ -0,0 +1,76 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `actor.cpp`
+/// =====================
+///
+/// N threads hammer one shared stateful interface value with `self &` calls.
+/// Compare guarding the value with a `std::mutex` against wrapping it in a
+/// `poly::actor`. Both times include running every call; for the actor, up
+/// to the result of a final `value(a)` call.
+
+#include <poly/actor.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+POLY_CALLABLE(add);
+POLY_CALLABLE(value);
+
+struct accumulator : poly::interface<accumulator
+    , void(add_, poly::self &, long)
+    , long(value_, poly::self const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(accumulator); };
+
+struct stats { long sum = 0, count = 0; };
+void call(add_, stats & s, long x) { s.sum += x; ++s.count; }
+long call(value_, stats const & s) { return s.count; }
+
+// Run `body` on `threads` threads, then `finish()` once they are done.
+template <typename Body, typename Finish>
+double run_threads(std::size_t threads, Body body, Finish finish) {
+    typedef std::chrono::steady_clock clock;
+    auto t0 = clock::now();
+    std::vector<std::thread> ts;
+    for (std::size_t t = 0; t < threads; ++t) ts.emplace_back(body);
+    for (auto & t : ts) t.join();
+    finish();
+    return std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+}
+
+int main(int argc, char ** argv) {
+    std::size_t calls = argc > 1 ? std::atol(argv[1]) : 1000000;
+    std::size_t max_threads = std::max(2u, std::thread::hardware_concurrency());
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        std::size_t per_thread = calls / threads;
+
+        accumulator guarded = stats();
+        std::mutex m;
+        double locked = run_threads(threads, [&] {
+            for (std::size_t i = 0; i < per_thread; ++i) {
+                std::lock_guard<std::mutex> lock(m);
+                add(guarded, long(i));
+            }
+        }, [] {});
+
+        poly::thread_pool pool(1);
+        double mailbox;
+        {
+            poly::actor<accumulator> a(pool, stats());
+            mailbox = run_threads(threads, [&] {
+                for (std::size_t i = 0; i < per_thread; ++i) add(a, long(i));
+            }, [&] {
+                if (value(a).get() != long(per_thread * threads)) std::abort();
+            });
+        }
+
+        std::cout << threads << " threads: mutex " << locked << " ms, "
+                  << "actor " << mailbox << " ms" << std::endl;
+    }
+}
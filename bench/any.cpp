@@ -0,0 +1,94 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `any.cpp`
+/// ===================
+///
+/// Compare `poly::interface<>` against `std::any` (C++17) in constructing,
+/// move-assigning and casting small and string values.
+///
+///     any [values] [repetitions]
+
+#include <poly/interface.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <any>
+#endif
+
+template <typename Body>
+double time_ns(std::size_t n, Body body) {
+    typedef std::chrono::steady_clock clock;
+    auto t0 = clock::now();
+    body();
+    auto t1 = clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+struct poly_any {
+    typedef poly::interface<> type;
+    template <typename T> static T const * get(type const & x) {
+        return poly::cast<T>(&x);
+    }
+};
+
+#if __cplusplus >= 201703L
+struct std_any {
+    typedef std::any type;
+    template <typename T> static T const * get(type const & x) {
+        return std::any_cast<T>(&x);
+    }
+};
+#endif
+
+// Repeat over `n` values which stay in cache.
+template <typename Any, typename T>
+void run(char const * name, T const & value, std::size_t n, std::size_t r) {
+    typedef typename Any::type any;
+    std::vector<any> xs(n), ys(n);
+    double construct = time_ns(n * r, [&] {
+        for (std::size_t k = 0; k < r; ++k)
+            for (auto & x : xs) x = any(value);
+    });
+    double move = time_ns(n * r, [&] {
+        for (std::size_t k = 0; k < r; ++k) {
+            for (std::size_t i = 0; i < n; ++i) ys[i] = std::move(xs[i]);
+            xs.swap(ys);
+        }
+    });
+    std::size_t hits = 0;
+    double cast = time_ns(2 * n * r, [&] {
+        for (std::size_t k = 0; k < r; ++k) {
+            for (auto const & x : xs) {
+                hits += Any::template get<T>(x) != nullptr;
+                hits += Any::template get<char>(x) != nullptr;
+            }
+        }
+    });
+    if (hits != n * r) std::abort();
+    std::cout << name << ": construct " << construct << " ns, move " << move
+              << " ns, cast " << cast << " ns (" << sizeof(any) << " bytes)"
+              << std::endl;
+}
+
+int main(int argc, char ** argv) {
+    std::size_t n = argc > 1 ? std::atol(argv[1]) : 1000;
+    std::size_t r = argc > 2 ? std::atol(argv[2]) : 1000;
+    std::string s = "twenty-character str";
+
+    run<poly_any>("poly::interface<> double", 1.5, n, r);
+    run<poly_any>("poly::interface<> string", s, n, r);
+#if __cplusplus >= 201703L
+    run<std_any>("std::any          double", 1.5, n, r);
+    run<std_any>("std::any          string", s, n, r);
+#else
+    std::cout << "(compile with -std=c++17 to compare with std::any)"
+              << std::endl;
+#endif
+}
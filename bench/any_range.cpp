@@ -0,0 +1,155 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `any_range.cpp`
+/// =========================
+///
+/// Sum a stream of `n` integers produced by a counting generator, consumed
+/// through a plain loop, a per-element virtual `next()`, a `std::function`
+/// generator, and `poly::any_range` (by iterator, by `for_each`, and by
+/// `for_each_chunk` summing each chunk in a local).
+///
+///     any_range [n]
+
+#include <poly/any_range.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+
+namespace ns {
+
+struct counter { long first, last; };
+
+std::size_t call(poly::next_chunk_, counter & c, long * out, std::size_t n) {
+    long first = c.first;
+    std::size_t k = std::min(n, std::size_t(c.last - first));
+    for (std::size_t i = 0; i < k; ++i) out[i] = first + long(i);
+    c.first = first + long(k);
+    return k;
+}
+
+} // ns
+
+// The classic per-element erasure.
+struct element_source {
+    virtual ~element_source() = default;
+    virtual bool next(long & x) = 0;
+};
+
+struct counting_source : element_source {
+    explicit counting_source(ns::counter c) : c(c) {}
+    virtual bool next(long & x) override {
+        if (c.first == c.last) return false;
+        x = c.first++;
+        return true;
+    }
+    ns::counter c;
+};
+
+// Opaque to the optimizer, so that no call is devirtualized or inlined.
+__attribute__((noinline))
+std::unique_ptr<element_source> make_virtual(long n) {
+    return std::unique_ptr<element_source>(new counting_source({0, n}));
+}
+
+__attribute__((noinline))
+std::function<bool(long &)> make_function(long n) {
+    ns::counter c = {0, n};
+    return [c](long & x) mutable {
+        if (c.first == c.last) return false;
+        x = c.first++;
+        return true;
+    };
+}
+
+__attribute__((noinline))
+poly::any_range<long> make_range(long n) {
+    return ns::counter{0, n};
+}
+
+// The best of five runs, in nanoseconds per element.
+template <typename Body>
+double time_ns(std::size_t n, Body body) {
+    typedef std::chrono::steady_clock clock;
+    double best = 0;
+    for (int i = 0; i < 5; ++i) {
+        auto t0 = clock::now();
+        body();
+        auto t1 = clock::now();
+        double t = std::chrono::duration<double, std::nano>(t1 - t0).count();
+        if (i == 0 || t < best) best = t;
+    }
+    return best / n;
+}
+
+int main(int argc, char ** argv) {
+    long n = argc > 1 ? std::atol(argv[1]) : 20000000;
+    long const expected = n * (n - 1) / 2;
+    long sum = 0;
+
+    double plain = time_ns(n, [&] {
+        ns::counter c = {0, n};
+        long buf[64];
+        long s = 0;
+        while (std::size_t k = call(poly::next_chunk_(), c, buf, 64))
+            for (std::size_t i = 0; i < k; ++i) s += buf[i];
+        sum = s;
+    });
+    if (sum != expected) return 1;
+
+    double per_element = time_ns(n, [&] {
+        std::unique_ptr<element_source> g = make_virtual(n);
+        long s = 0;
+        for (long x; g->next(x);) s += x;
+        sum = s;
+    });
+    if (sum != expected) return 1;
+
+    double function = time_ns(n, [&] {
+        std::function<bool(long &)> f = make_function(n);
+        long s = 0;
+        for (long x; f(x);) s += x;
+        sum = s;
+    });
+    if (sum != expected) return 1;
+
+    double iterated = time_ns(n, [&] {
+        poly::any_range<long> r = make_range(n);
+        long s = 0;
+        for (long x : r) s += x;
+        sum = s;
+    });
+    if (sum != expected) return 1;
+
+    double chunked = time_ns(n, [&] {
+        poly::any_range<long> r = make_range(n);
+        long s = 0;
+        r.for_each([&s](long x) { s += x; });
+        sum = s;
+    });
+    if (sum != expected) return 1;
+
+    double chunks = time_ns(n, [&] {
+        poly::any_range<long> r = make_range(n);
+        long s = 0;
+        r.for_each_chunk([&s](long const * first, long const * last) {
+            long t = 0;
+            for (; first != last; ++first) t += *first;
+            s += t;
+        });
+        sum = s;
+    });
+    if (sum != expected) return 1;
+
+    std::cout << "plain loop         : " << plain << " ns" << std::endl;
+    std::cout << "virtual next()     : " << per_element << " ns" << std::endl;
+    std::cout << "std::function      : " << function << " ns" << std::endl;
+    std::cout << "any_range iterator : " << iterated << " ns" << std::endl;
+    std::cout << "any_range for_each : " << chunked << " ns" << std::endl;
+    std::cout << "any_range chunks   : " << chunks << " ns" << std::endl;
+}
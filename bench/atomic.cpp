@@ -0,0 +1,101 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `atomic.cpp`
+/// ======================
+///
+/// Reader scalability of an interface value replaced now and then: `1` to
+/// `max_threads` threads each route `n` keys through the current strategy,
+/// read from a `poly::atomic`, or under a `std::shared_mutex` (C++17 and
+/// later only). A writer replaces the strategy every millisecond meanwhile.
+/// Prints the total reads per microsecond.
+///
+///     atomic [max_threads] [n]
+
+#include <poly/atomic.hpp>
+#include <poly/interface.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#if __cplusplus >= 201703L
+#include <shared_mutex>
+#endif
+
+namespace ns {
+
+POLY_CALLABLE(route);
+
+struct router : poly::interface<router
+    , int(route_, poly::self const &, int)
+    > { POLY_INTERFACE_CONSTRUCTORS(router); };
+
+struct modulo { int n; };
+
+int call(route_, modulo const & m, int key) { return key % m.n; }
+
+} // ns
+
+// Reads per microsecond of `threads` readers making `n` reads each through
+// `read(key)`, while `write(i)` is called every millisecond.
+template <typename Read, typename Write>
+double throughput(int threads, long n, Read read, Write write) {
+    typedef std::chrono::steady_clock clock;
+    std::atomic<int> running(threads);
+    std::atomic<long> total(0);
+    std::vector<std::thread> readers;
+    auto t0 = clock::now();
+    for (int i = 0; i < threads; ++i) {
+        readers.emplace_back([&] {
+            long s = 0;
+            for (long k = 0; k < n; ++k) s += read(int(k));
+            total += s;
+            --running;
+        });
+    }
+    for (int i = 0; running; ++i) {
+        write(i);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (auto & t : readers) t.join();
+    auto t1 = clock::now();
+    if (total < 0) std::abort();
+    double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+    return threads * n / us;
+}
+
+int main(int argc, char ** argv) {
+    int max_threads = argc > 1 ? std::atoi(argv[1]) : 64;
+    long n = argc > 2 ? std::atol(argv[2]) : 1000000;
+
+    std::cout << "threads  poly::atomic  std::shared_mutex" << std::endl;
+    for (int t = 1; t <= max_threads; t *= 2) {
+        poly::atomic<ns::router> a(ns::modulo{7});
+        double rcu = throughput(t, n,
+            [&](int k) { return ns::route(*a.load(), k); },
+            [&](int i) { a.store(ns::modulo{7 + i % 2}); });
+        std::cout << t << "\t " << rcu;
+
+#if __cplusplus >= 201703L
+        std::shared_mutex m;
+        ns::router r = ns::modulo{7};
+        double locked = throughput(t, n,
+            [&](int k) {
+                std::shared_lock<std::shared_mutex> lock(m);
+                return ns::route(r, k);
+            },
+            [&](int i) {
+                ns::router x = ns::modulo{7 + i % 2};
+                std::unique_lock<std::shared_mutex> lock(m);
+                r = std::move(x);
+            });
+        std::cout << "\t\t" << locked;
+#endif
+        std::cout << std::endl;
+    }
+}
@@ -0,0 +1,156 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `code_size.cpp`
+/// =========================
+///
+/// Not timed: measures how much machine code models cost. Compiled with
+/// `-DMODELS=m -DSIGNATURES=s`, this instantiates `m` models (half of them
+/// trivially copyable, half holding a `std::string`) of an interface with `s`
+/// signatures, `0 <= s <= 8`, and calls each signature on each.
+///
+/// `bench/code_size.sh` builds it for a few values of `m` and `s` and reports
+/// the growth of `.text` per model type and per signature of a model:
+///
+///     CXX=clang++ CXXFLAGS=-Os bench/code_size.sh
+///
+/// With identical code folding, the linker merges the functions which models
+/// of similar types compile to alike:
+///
+///     export LDFLAGS="-fuse-ld=gold -Wl,--icf=all"
+///     CXXFLAGS="-O2 -ffunction-sections" bench/code_size.sh
+
+#include <poly/interface.hpp>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#ifndef MODELS
+#define MODELS 16
+#endif
+
+#ifndef SIGNATURES
+#define SIGNATURES 4
+#endif
+
+namespace ns {
+
+POLY_CALLABLE(f0); POLY_CALLABLE(f1); POLY_CALLABLE(f2); POLY_CALLABLE(f3);
+POLY_CALLABLE(f4); POLY_CALLABLE(f5); POLY_CALLABLE(f6); POLY_CALLABLE(f7);
+
+#define POLY_SIZE_SIGNATURE(k) , int(f##k##_, poly::self const &, int)
+
+struct measured : poly::interface<measured
+#if SIGNATURES > 0
+    POLY_SIZE_SIGNATURE(0)
+#endif
+#if SIGNATURES > 1
+    POLY_SIZE_SIGNATURE(1)
+#endif
+#if SIGNATURES > 2
+    POLY_SIZE_SIGNATURE(2)
+#endif
+#if SIGNATURES > 3
+    POLY_SIZE_SIGNATURE(3)
+#endif
+#if SIGNATURES > 4
+    POLY_SIZE_SIGNATURE(4)
+#endif
+#if SIGNATURES > 5
+    POLY_SIZE_SIGNATURE(5)
+#endif
+#if SIGNATURES > 6
+    POLY_SIZE_SIGNATURE(6)
+#endif
+#if SIGNATURES > 7
+    POLY_SIZE_SIGNATURE(7)
+#endif
+    > { POLY_INTERFACE_CONSTRUCTORS(measured); };
+
+template <int N> struct plain {
+    explicit plain(int n) : n(n) {}
+    int n;
+};
+
+template <int N> struct named {
+    explicit named(int n) : n(n), s("model") {}
+    int n;
+    std::string s;
+};
+
+#define POLY_SIZE_CALL(k)                                                   \
+    template <int N> int call(f##k##_, plain<N> const & x, int a) {         \
+        return x.n * (N + k) + a;                                           \
+    }                                                                       \
+    template <int N> int call(f##k##_, named<N> const & x, int a) {         \
+        return x.n * (N + k) + int(x.s.size()) + a;                         \
+    }                                                                       \
+    /**/
+
+POLY_SIZE_CALL(0) POLY_SIZE_CALL(1) POLY_SIZE_CALL(2) POLY_SIZE_CALL(3)
+POLY_SIZE_CALL(4) POLY_SIZE_CALL(5) POLY_SIZE_CALL(6) POLY_SIZE_CALL(7)
+
+int call_all(measured const & x, int a) {
+    int r = 0;
+#if SIGNATURES > 0
+    r += f0(x, a);
+#endif
+#if SIGNATURES > 1
+    r += f1(x, a);
+#endif
+#if SIGNATURES > 2
+    r += f2(x, a);
+#endif
+#if SIGNATURES > 3
+    r += f3(x, a);
+#endif
+#if SIGNATURES > 4
+    r += f4(x, a);
+#endif
+#if SIGNATURES > 5
+    r += f5(x, a);
+#endif
+#if SIGNATURES > 6
+    r += f6(x, a);
+#endif
+#if SIGNATURES > 7
+    r += f7(x, a);
+#endif
+    return r;
+}
+
+typedef measured (*maker)();
+
+template <int N> measured make() {
+    return typename std::conditional<N % 2 != 0,
+        named<N>, plain<N>>::type(N);
+}
+
+// Fills `m` with the makers of models 0 to `N - 1`.
+template <int N> struct instantiate {
+    static void into(maker * m) {
+        m[N - 1] = &make<N - 1>;
+        instantiate<N - 1>::into(m);
+    }
+};
+
+template <> struct instantiate<0> {
+    static void into(maker *) {}
+};
+
+} // ns
+
+int main(int argc, char **) {
+    ns::maker makers[MODELS + 1];
+    ns::instantiate<MODELS>::into(makers);
+    std::vector<ns::measured> v;
+    for (int i = 0; i < MODELS; ++i) v.push_back(makers[i]());
+    std::vector<ns::measured> w = v;
+    int r = 0;
+    for (auto const & x : w) r += ns::call_all(x, argc);
+    std::cout << v.size() << " models, " << SIGNATURES << " signatures: "
+              << r << std::endl;
+}
@@ -0,0 +1,34 @@
+#!/bin/sh
+# Copyright 2012 Pyry Jahkola.
+#
+# Distributed under the Boost Software License, Version 1.0. (See accompanying
+# file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+# Size report: the `.text` bytes each model type, and each signature of a
+# model, adds to a program. See bench/code_size.cpp. Run from anywhere;
+# `CXX`, `CXXFLAGS`, `LDFLAGS` and `MODELS` (the number of model types to
+# average over) select the build.
+
+set -e
+cd "$(dirname "$0")/.."
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--O2}
+MODELS=${MODELS:-64}
+out=${TMPDIR:-/tmp}/poly_code_size.$$
+trap 'rm -f "$out"' EXIT
+
+text() {
+    $CXX -std=c++11 $CXXFLAGS $LDFLAGS -Iinclude \
+        -DMODELS=$1 -DSIGNATURES=$2 bench/code_size.cpp -o "$out"
+    size -A "$out" | awk '$1 == ".text" { print $2 }'
+}
+
+echo "$CXX $CXXFLAGS $LDFLAGS, averaged over $MODELS model types"
+for s in 1 2 4 8; do
+    base=$(text 0 $s)
+    full=$(text $MODELS $s)
+    per=$(( (full - base) / MODELS ))
+    echo "  $s signatures: $per bytes/model"
+    [ $s = 1 ] && one=$per
+    [ $s = 8 ] && echo "  each signature: $(( (per - one) / 7 )) bytes/model"
+done
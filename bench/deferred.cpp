@@ -0,0 +1,102 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `deferred.cpp`
+/// ========================
+///
+/// The latency of dropping the last interface to a large nested document,
+/// destroyed either synchronously or by the reclaimer of <poly/deferred.hpp>.
+/// Every round builds a document of `n` sections of `m` strings, then times
+/// dropping it, including the `flush_deferred()` call. The reclaimer is
+/// drained between rounds, outside the timing.
+///
+///     deferred [rounds] [n] [m]
+
+#include <poly/deferred.hpp>
+#include <poly/interface.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace ns {
+
+POLY_CALLABLE(size);
+
+struct sized : poly::interface<sized
+    , std::size_t(size_, poly::self const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(sized); };
+
+struct section {
+    std::vector<std::string> lines;
+};
+
+template <int Tag> struct document {
+    std::vector<sized> sections;
+};
+
+typedef document<0> sync_document;
+typedef document<1> deferred_document;
+
+std::size_t call(size_, section const & s) { return s.lines.size(); }
+
+template <int Tag>
+std::size_t call(size_, document<Tag> const & d) { return d.sections.size(); }
+
+template <typename Document>
+sized make_document(std::size_t n, std::size_t m) {
+    Document d;
+    d.sections.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        section s;
+        for (std::size_t j = 0; j < m; ++j)
+            s.lines.push_back(std::string(40, char('a' + j % 26)));
+        d.sections.push_back(std::move(s));
+    }
+    return sized(std::move(d));
+}
+
+} // ns
+
+namespace poly {
+template <> struct is_deferred<ns::deferred_document> : std::true_type {};
+} // poly
+
+// The drop latencies of `rounds` documents, in microseconds, sorted.
+template <typename Document>
+std::vector<double> drop_us(int rounds, std::size_t n, std::size_t m) {
+    typedef std::chrono::steady_clock clock;
+    std::vector<double> t;
+    for (int i = 0; i < rounds; ++i) {
+        auto d = new ns::sized(ns::make_document<Document>(n, m));
+        if (ns::size(*d) != n) std::abort();
+        auto t0 = clock::now();
+        delete d;
+        poly::flush_deferred();
+        auto t1 = clock::now();
+        t.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+        poly::drain_deferred();
+    }
+    std::sort(t.begin(), t.end());
+    return t;
+}
+
+void report(char const * name, std::vector<double> const & t) {
+    std::cout << name
+              << "p50 " << t[t.size() / 2] << " us, "
+              << "p99 " << t[t.size() * 99 / 100] << " us, "
+              << "max " << t.back() << " us" << std::endl;
+}
+
+int main(int argc, char ** argv) {
+    int rounds = argc > 1 ? std::atoi(argv[1]) : 200;
+    std::size_t n = argc > 2 ? std::atol(argv[2]) : 1000;
+    std::size_t m = argc > 3 ? std::atol(argv[3]) : 20;
+
+    report("synchronous : ", drop_us<ns::sync_document>(rounds, n, m));
+    report("deferred    : ", drop_us<ns::deferred_document>(rounds, n, m));
+}
@@ -0,0 +1,81 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `drawable.cpp`
+/// ========================
+///
+/// Redraw a document of `sections * leaves` numbers after editing a single
+/// one of them, like a live dashboard. Compare drawing a plain document of
+/// `example::drawable` against a document of `example::cached`, which
+/// re-renders only the edited path. The output goes to a stream which drops
+/// it, so only the cost of rendering is measured.
+
+#include "../example/drawable.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <streambuf>
+
+// Counts the characters written, and drops them.
+struct null_buffer : std::streambuf {
+    std::size_t count = 0;
+    int_type overflow(int_type c) override { ++count; return c; }
+    std::streamsize xsputn(char const *, std::streamsize n) override {
+        count += std::size_t(n);
+        return n;
+    }
+};
+
+typedef std::chrono::steady_clock clock_type;
+
+static double ms_since(clock_type::time_point t0) {
+    std::chrono::duration<double, std::milli> d = clock_type::now() - t0;
+    return d.count();
+}
+
+template <typename Node, typename Edit>
+void run(char const * name, Node & doc, Edit edit, std::size_t redraws) {
+    null_buffer buf;
+    std::ostream out(&buf);
+    auto t0 = clock_type::now();
+    example::draw(doc, out, 0);
+    double first = ms_since(t0);
+
+    t0 = clock_type::now();
+    for (std::size_t i = 0; i < redraws; ++i) {
+        edit(doc, i);
+        example::draw(doc, out, 0);
+    }
+    std::cout << name << ": first draw " << first << " ms, redraw after edit "
+              << ms_since(t0) / double(redraws) << " ms, "
+              << buf.count / (redraws + 1) << " bytes/draw" << std::endl;
+}
+
+int main(int argc, char ** argv) {
+    using example::cached;
+    using example::drawable;
+    std::size_t sections = argc > 1 ? std::atol(argv[1]) : 1000;
+    std::size_t leaves = argc > 2 ? std::atol(argv[2]) : 1000;
+    std::size_t redraws = argc > 3 ? std::atol(argv[3]) : 10;
+
+    {
+        std::vector<drawable> doc;
+        for (std::size_t i = 0; i < sections; ++i)
+            doc.push_back(std::vector<drawable>(leaves, int(i)));
+        run("plain ", doc, [&](std::vector<drawable> & d, std::size_t i) {
+            d[i % sections].get<std::vector<drawable>>()[i % leaves] = int(i);
+        }, redraws);
+    }
+    {
+        std::vector<cached> sections_;
+        for (std::size_t i = 0; i < sections; ++i)
+            sections_.push_back(std::vector<cached>(leaves, int(i)));
+        cached doc = std::move(sections_);
+        run("cached", doc, [&](cached & d, std::size_t i) {
+            d.edit<std::vector<cached>>()[i % sections]
+             .edit<std::vector<cached>>()[i % leaves] = int(i);
+        }, redraws);
+    }
+}
@@ -0,0 +1,67 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `function.cpp`
+/// ========================
+///
+/// Compare `poly::function` against `std::function` in constructing (and
+/// destroying) a wrapper for a small and a large function object, and in
+/// invoking it.
+
+#include <poly/function.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <vector>
+
+struct small_arr {
+    long a[2];
+    long operator()(long x) const { return a[0] * x + a[1]; }
+};
+
+struct large_fn {
+    long a[6];
+    long operator()(long x) const { return a[0] * x + a[5]; }
+};
+
+template <typename Body>
+double time_ns(std::size_t n, Body body) {
+    typedef std::chrono::steady_clock clock;
+    auto t0 = clock::now();
+    body();
+    auto t1 = clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+template <typename Function, typename F>
+void run(char const * name, F f, std::size_t n) {
+    long sink = 0;
+    double construct = time_ns(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) {
+            f.a[0] = long(i);
+            Function g = f;
+            Function h = std::move(g);
+            sink += h(1);
+        }
+    });
+    std::vector<Function> fs(1024, Function(f));
+    double invoke = time_ns(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) sink += fs[i & 1023](long(i));
+    });
+    std::cout << name << ": construct+move+call " << construct << " ns, "
+              << "call " << invoke << " ns  (" << (sink & 1) << ")"
+              << std::endl;
+}
+
+int main(int argc, char ** argv) {
+    std::size_t n = argc > 1 ? std::atol(argv[1]) : 10000000;
+    small_arr s = {{2, 3}};
+    large_fn l = {{2, 0, 0, 0, 0, 3}};
+    run<std::function<long(long)>>("std::function,  small", s, n);
+    run<poly::function<long(long)>>("poly::function, small", s, n);
+    run<std::function<long(long)>>("std::function,  large", l, n);
+    run<poly::function<long(long)>>("poly::function, large", l, n);
+}
@@ -0,0 +1,62 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `lazy.cpp`
+/// ====================
+///
+/// Compute `a * b + c` over vectors of interfaces holding `double`s, node by
+/// node through the interface signatures and fused with <poly/lazy.hpp>, and
+/// over plain `double`s for reference.
+
+#include <poly/lazy.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+struct number : poly::interface<number
+    , number(poly::operator_add_, poly::self const &, number const &)
+    , number(poly::operator_mul_, poly::self const &, number const &)
+    >
+{ POLY_INTERFACE_CONSTRUCTORS(number); };
+
+template <typename Body>
+double time_ns(std::size_t n, Body body) {
+    typedef std::chrono::steady_clock clock;
+    auto t0 = clock::now();
+    body();
+    auto t1 = clock::now();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+int main(int argc, char ** argv) {
+    std::size_t n = argc > 1 ? std::atol(argv[1]) : 1000000;
+    std::vector<double> xs(n), ys(n), zs(n), rs(n);
+    std::vector<number> a, b, c, r(n, number(0.0));
+    for (std::size_t i = 0; i < n; ++i) {
+        xs[i] = double(i); ys[i] = 0.5; zs[i] = 1.0;
+        a.push_back(xs[i]); b.push_back(ys[i]); c.push_back(zs[i]);
+    }
+
+    double native = time_ns(n, [&] {
+        for (std::size_t i = 0; i < n; ++i) rs[i] = xs[i] * ys[i] + zs[i];
+    });
+    double nodewise = time_ns(n, [&] {
+        for (std::size_t i = 0; i < n; ++i)
+            r[i] = poly::operator_add(poly::operator_mul(a[i], b[i]), c[i]);
+    });
+    double fused = time_ns(n, [&] {
+        using poly::lazy;
+        for (std::size_t i = 0; i < n; ++i) {
+            poly::evaluate<double>(r[i], poly::operator_add(
+                poly::operator_mul(lazy(a[i]), b[i]), c[i]));
+        }
+    });
+
+    if (poly::cast<double>(r[n - 1]) != rs[n - 1]) return 1;
+    std::cout << "native  : " << native << " ns" << std::endl;
+    std::cout << "nodewise: " << nodewise << " ns" << std::endl;
+    std::cout << "fused   : " << fused << " ns" << std::endl;
+}
@@ -0,0 +1,84 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `memoized.cpp`
+/// ========================
+///
+/// The cost of calling a pure function of a string directly, and through
+/// `poly::memoized` with `threads` threads. Each thread makes `n` calls on
+/// arguments drawn from `keys` distinct strings; with more keys than the
+/// capacity of the cache, some of the calls miss.
+///
+///     memoized [n] [keys] [threads]
+
+#include <poly/memoized.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns {
+
+POLY_CALLABLE(measure);
+
+// Something not too cheap: a few hundred operations per call.
+std::size_t call(measure_, std::string const & s) {
+    std::size_t w = 0;
+    for (int i = 0; i < 8; ++i)
+        for (char c : s) w = w * 31 + (c ^ i) % 7;
+    return w;
+}
+
+} // ns
+
+template <typename F>
+double ns_per_call(F f, std::vector<std::string> const & keys,
+                   std::size_t n, int threads)
+{
+    typedef std::chrono::steady_clock clock;
+    std::vector<std::thread> ts;
+    std::vector<std::size_t> sums(threads);
+    auto t0 = clock::now();
+    for (int t = 0; t < threads; ++t) {
+        ts.emplace_back([&, t] {
+            std::minstd_rand r(t + 1);
+            std::uniform_int_distribution<std::size_t> d(0, keys.size() - 1);
+            std::size_t sum = 0;
+            for (std::size_t i = 0; i < n; ++i) sum += f(keys[d(r)]);
+            sums[t] = sum;
+        });
+    }
+    for (auto & t : ts) t.join();
+    auto t1 = clock::now();
+    std::size_t sum = 0;
+    for (auto s : sums) sum += s;
+    if (sum == 42) std::cout << "";
+    return std::chrono::duration<double, std::nano>(t1 - t0).count() /
+           (double(n) * threads);
+}
+
+int main(int argc, char ** argv) {
+    std::size_t n = argc > 1 ? std::atol(argv[1]) : 1000000;
+    std::size_t nkeys = argc > 2 ? std::atol(argv[2]) : 2000;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 1;
+
+    std::vector<std::string> keys;
+    for (std::size_t i = 0; i < nkeys; ++i)
+        keys.push_back("label " + std::to_string(i) + std::string(24, 'x'));
+
+    poly::memoized<ns::measure_> memo;
+    std::cout << "direct   : "
+              << ns_per_call(ns::measure, keys, n, threads) << " ns/call"
+              << std::endl;
+    double t = ns_per_call(
+        [&memo](std::string const & s) { return memo(s); }, keys, n, threads);
+    poly::memoized_stats s = memo.stats();
+    std::cout << "memoized : " << t << " ns/call, "
+              << s.hits << " hits, " << s.misses << " misses, "
+              << s.evictions << " evictions" << std::endl;
+}
@@ -0,0 +1,49 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `persistent_vector.cpp`
+/// =================================
+///
+/// Keep an undo history of a growing document: after every edit, take a
+/// snapshot of the whole document. Compare the time and the number of bytes
+/// allocated by `std::vector<example::drawable>` and
+/// `poly::persistent_vector<example::drawable>`.
+
+#include "../example/drawable.hpp"
+#include "../test/count_allocations.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+template <typename Document>
+void run(char const * name, std::size_t size, std::size_t edits) {
+    typedef std::chrono::steady_clock clock;
+    Document doc;
+    for (std::size_t i = 0; i < size; ++i) doc.push_back(int(i));
+    std::vector<Document> history;
+    history.reserve(edits);
+
+    std::size_t bytes = allocated;
+    auto t0 = clock::now();
+    for (std::size_t i = 0; i < edits; ++i) {
+        history.push_back(doc);                     // snapshot
+        doc.push_back(std::string("edit"));         // edit
+    }
+    auto t1 = clock::now();
+    bytes = allocated - bytes;
+
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(t1 - t0);
+    std::cout << name << ": " << size << " elements, " << edits << " edits: "
+              << us.count() / double(edits) << " us/edit, "
+              << bytes / edits << " bytes/edit" << std::endl;
+}
+
+int main(int argc, char ** argv) {
+    std::size_t size = argc > 1 ? std::atol(argv[1]) : 100000;
+    std::size_t edits = argc > 2 ? std::atol(argv[2]) : 100;
+    run<std::vector<example::drawable>>("std::vector      ", size, edits);
+    run<poly::persistent_vector<example::drawable>>(
+        "persistent_vector", size, edits);
+}
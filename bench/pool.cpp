@@ -0,0 +1,140 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `pool.cpp`
+/// ====================
+///
+/// Create interfaces on N producer threads and destroy them on M consumer
+/// threads, with the models allocated from the global heap or from the model
+/// pool of <poly/pool.hpp>.
+///
+///     pool [producers] [consumers] [messages per producer]
+
+#include <poly/pool.hpp>
+#include <poly/interface.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+template <int Tag> struct message {
+    long id;
+    long payload[4];
+};
+
+typedef message<0> heap_message;
+typedef message<1> pooled_message;
+
+namespace poly {
+template <> struct is_pooled<pooled_message> : std::true_type {};
+} // poly
+
+POLY_CALLABLE(id);
+
+template <int Tag> long call(id_, message<Tag> const & m) { return m.id; }
+
+typedef poly::interface<long(id_, poly::self const &)> any_message;
+
+// Batches of messages handed from the producers to the consumers.
+class channel {
+public:
+    channel() : open(0) {}
+
+    void push(std::vector<any_message> b) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            batches.push_back(std::move(b));
+        }
+        cv.notify_one();
+    }
+
+    bool pop(std::vector<any_message> & b) {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [this] { return open == 0 || !batches.empty(); });
+        if (batches.empty()) return false;
+        b = std::move(batches.front());
+        batches.pop_front();
+        return true;
+    }
+
+    void add_producer() { std::lock_guard<std::mutex> lock(m); ++open; }
+    void remove_producer() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            --open;
+        }
+        cv.notify_all();
+    }
+
+private:
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<std::vector<any_message>> batches;
+    int open;
+};
+
+template <typename Message>
+double run(std::size_t producers, std::size_t consumers, std::size_t n) {
+    std::size_t const batch = 256;
+    channel ch;
+    for (std::size_t i = 0; i < producers; ++i) ch.add_producer();
+
+    typedef std::chrono::steady_clock clock;
+    auto t0 = clock::now();
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < producers; ++i) {
+        threads.emplace_back([&ch, n, batch] {
+            std::vector<any_message> b;
+            for (std::size_t j = 0; j < n; ++j) {
+                b.push_back(Message{long(j), {}});
+                if (b.size() == batch) {
+                    ch.push(std::move(b));
+                    b.clear();
+                    b.reserve(batch);
+                }
+            }
+            if (!b.empty()) ch.push(std::move(b));
+            ch.remove_producer();
+        });
+    }
+    long sum = 0;
+    std::mutex sum_m;
+    for (std::size_t i = 0; i < consumers; ++i) {
+        threads.emplace_back([&] {
+            long s = 0;
+            std::vector<any_message> b;
+            while (ch.pop(b)) {
+                for (auto const & x : b) s += id(x);
+                b.clear();
+            }
+            std::lock_guard<std::mutex> lock(sum_m);
+            sum += s;
+        });
+    }
+    for (auto & t : threads) t.join();
+    auto t1 = clock::now();
+    if (sum != long(producers * (n * (n - 1) / 2))) std::abort();
+    return std::chrono::duration<double, std::nano>(t1 - t0).count()
+        / (producers * n);
+}
+
+int main(int argc, char ** argv) {
+    std::size_t producers = argc > 1 ? std::atol(argv[1]) : 4;
+    std::size_t consumers = argc > 2 ? std::atol(argv[2]) : 4;
+    std::size_t n = argc > 3 ? std::atol(argv[3]) : 1000000;
+
+    std::cout << producers << " producers, " << consumers << " consumers, "
+              << n << " messages each" << std::endl;
+    std::cout << "global heap: "
+              << run<heap_message>(producers, consumers, n)
+              << " ns/message" << std::endl;
+    std::cout << "model pool : "
+              << run<pooled_message>(producers, consumers, n)
+              << " ns/message" << std::endl;
+}
@@ -0,0 +1,68 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `relocate.cpp`
+/// ========================
+///
+/// Grow a `std::vector` of 10^6 interfaces without reserving, and sort it.
+/// Compare interfaces (trivially relocatable) against the same interface
+/// wrapped in a struct that is not declared relocatable, and `std::sort`
+/// against `poly::sort`.
+
+#include <poly/relocate.hpp>
+#include <poly/interface.hpp>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+
+POLY_CALLABLE(key);
+
+int call(key_, int i) { return i; }
+
+using keyed = poly::interface<int(key_, poly::self const &)>;
+
+struct boxed {
+    boxed(int i) : x(i) {}
+    keyed x;
+};
+
+template <typename Body>
+double time_ms(Body body) {
+    typedef std::chrono::steady_clock clock;
+    auto t0 = clock::now();
+    body();
+    return std::chrono::duration<double, std::milli>(clock::now() - t0).count();
+}
+
+template <typename T>
+void grow(char const * name, std::size_t n) {
+    std::vector<T> v;
+    double ms = time_ms([&] {
+        for (std::size_t i = 0; i < n; ++i) v.push_back(int(i));
+    });
+    std::cout << name << " push_back x " << n << ": " << ms << " ms"
+              << std::endl;
+}
+
+int main(int argc, char ** argv) {
+    std::size_t n = argc > 1 ? std::atol(argv[1]) : 1000000;
+
+    grow<boxed>("move + destroy", n);
+    grow<keyed>("memmove       ", n);
+
+    auto less = [](keyed const & a, keyed const & b) noexcept {
+        return key(a) < key(b);
+    };
+    std::vector<keyed> v, w;
+    for (std::size_t i = 0; i < n; ++i) {
+        int k = int((i * 2654435761u) % n);
+        v.push_back(k);
+        w.push_back(k);
+    }
+    double s = time_ms([&] { std::sort(v.begin(), v.end(), less); });
+    double p = time_ms([&] { poly::sort(w, less); });
+    std::cout << "std::sort : " << s << " ms" << std::endl;
+    std::cout << "poly::sort: " << p << " ms" << std::endl;
+}
@@ -0,0 +1,136 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `scheduler.cpp`
+/// =========================
+///
+/// Throughput of small tasks on N threads: `poly::scheduler` against a pool
+/// of `std::function<void()>` tasks behind one mutex-guarded queue. Two
+/// workloads:
+///
+/// - flat: the main thread spawns all the tasks.
+/// - nested: a binary tree of tasks, each spawning its two children.
+///
+/// Also counts the allocations per task.
+
+#include <poly/scheduler.hpp>
+#include "../test/count_allocations.hpp"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// The baseline: one queue of `std::function`s, and a count of the tasks yet
+// to finish for `wait()`.
+class function_pool {
+public:
+    explicit function_pool(std::size_t n) : pending(0), stopping(false) {
+        for (std::size_t i = 0; i < n; ++i)
+            workers.emplace_back([this] { work(); });
+    }
+
+    ~function_pool() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto & w : workers) w.join();
+    }
+
+    void spawn(std::function<void()> f) {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            ++pending;
+            tasks.push_back(std::move(f));
+        }
+        ready.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m);
+        finished.wait(lock, [this] { return pending == 0; });
+    }
+
+private:
+    void work() {
+        for (;;) {
+            std::function<void()> f;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                ready.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;
+                f = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            f();
+            std::lock_guard<std::mutex> lock(m);
+            if (--pending == 0) finished.notify_all();
+        }
+    }
+
+    std::mutex m;
+    std::condition_variable ready;
+    std::condition_variable finished;
+    std::deque<std::function<void()>> tasks;
+    std::size_t pending;
+    bool stopping;
+    std::vector<std::thread> workers;
+};
+
+// A little work for each task.
+static void work(long i) {
+    static thread_local long sink = 0;
+    for (int k = 0; k < 16; ++k) sink = sink * 31 + i + k;
+}
+
+template <typename Pool>
+void tree(Pool & p, int depth, long i) {
+    work(i);
+    if (depth == 0) return;
+    p.spawn([&p, depth, i] { tree(p, depth - 1, 2 * i); });
+    p.spawn([&p, depth, i] { tree(p, depth - 1, 2 * i + 1); });
+}
+
+template <typename Pool>
+void run(char const * name, std::size_t threads, long tasks, int depth) {
+    typedef std::chrono::steady_clock clock;
+    Pool p(threads);
+
+    std::size_t a0 = allocations;
+    auto t0 = clock::now();
+    for (long i = 0; i < tasks; ++i) p.spawn([i] { work(i); });
+    p.wait();
+    std::chrono::duration<double> flat = clock::now() - t0;
+    std::size_t a1 = allocations;
+
+    long nodes = (2L << depth) - 1;
+    t0 = clock::now();
+    p.spawn([&p, depth] { tree(p, depth, 1); });
+    p.wait();
+    std::chrono::duration<double> nested = clock::now() - t0;
+    std::size_t a2 = allocations;
+
+    std::cout << name << " " << threads << " threads: flat "
+              << tasks / flat.count() / 1e6 << " M tasks/s, "
+              << double(a1 - a0) / tasks << " allocations/task; nested "
+              << nodes / nested.count() / 1e6 << " M tasks/s, "
+              << double(a2 - a1) / nodes << " allocations/task" << std::endl;
+}
+
+int main(int argc, char ** argv) {
+    std::size_t threads = argc > 1 ? std::atol(argv[1])
+        : std::max(1u, std::thread::hardware_concurrency());
+    long tasks = argc > 2 ? std::atol(argv[2]) : 1000000;
+    int depth = argc > 3 ? std::atoi(argv[3]) : 19;
+    run<function_pool>("std::function pool", threads, tasks, depth);
+    run<poly::scheduler>("poly::scheduler   ", threads, tasks, depth);
+}
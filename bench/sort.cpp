@@ -0,0 +1,107 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+/// Benchmark `sort.cpp`
+/// ====================
+///
+/// Sorting `n` interfaces holding a mix of three types by their value: with
+/// `std::sort` and `std::stable_sort` comparing through an interface
+/// signature `bool(poly::operator_lt_, poly::self const &, number const &)`,
+/// and with `poly::sort_by_key`. Every round sorts a fresh shuffle.
+///
+///     sort [n] [rounds]
+
+#include <poly/sort.hpp>
+#include <poly/interface.hpp>
+#include <poly/operators.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace ns {
+
+POLY_CALLABLE(value);
+
+struct number : poly::interface<number
+    , double(value_, poly::self const &)
+    , bool(poly::operator_lt_, poly::self const &, number const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(number); };
+
+struct integer { long n; };
+struct real { double x; };
+struct fraction { int p, q; };
+
+double call(value_, integer const & i) { return double(i.n); }
+double call(value_, real const & r) { return r.x; }
+double call(value_, fraction const & f) { return double(f.p) / f.q; }
+
+bool call(poly::operator_lt_, integer const & a, number const & b) {
+    return call(value, a) < value(b);
+}
+bool call(poly::operator_lt_, real const & a, number const & b) {
+    return call(value, a) < value(b);
+}
+bool call(poly::operator_lt_, fraction const & a, number const & b) {
+    return call(value, a) < value(b);
+}
+
+} // ns
+
+std::vector<ns::number> make_numbers(std::size_t n) {
+    std::mt19937 r(1);
+    std::vector<ns::number> xs;
+    xs.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        int const k = int(r() % 1000000);
+        switch (i % 3) {
+        case 0: xs.push_back(ns::integer{k}); break;
+        case 1: xs.push_back(ns::real{k + 0.25}); break;
+        default: xs.push_back(ns::fraction{k, 3}); break;
+        }
+    }
+    return xs;
+}
+
+template <typename Sort>
+double ms_per_sort(std::vector<ns::number> xs, int rounds, Sort sort) {
+    typedef std::chrono::steady_clock clock;
+    std::mt19937 r(2);
+    double total = 0;
+    for (int i = 0; i < rounds; ++i) {
+        std::shuffle(xs.begin(), xs.end(), r);
+        auto t0 = clock::now();
+        sort(xs);
+        auto t1 = clock::now();
+        total += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        for (std::size_t j = 1; j < xs.size(); ++j)
+            if (ns::value(xs[j]) < ns::value(xs[j - 1])) std::abort();
+    }
+    return total / rounds;
+}
+
+int main(int argc, char ** argv) {
+    std::size_t n = argc > 1 ? std::atol(argv[1]) : 1000000;
+    int rounds = argc > 2 ? std::atoi(argv[2]) : 5;
+
+    std::vector<ns::number> const xs = make_numbers(n);
+    auto less = [](ns::number const & a, ns::number const & b) {
+        return poly::operator_lt(a, b);
+    };
+    std::cout << "std::sort          : " << ms_per_sort(xs, rounds,
+        [&](std::vector<ns::number> & v) {
+            std::sort(v.begin(), v.end(), less);
+        }) << " ms" << std::endl;
+    std::cout << "std::stable_sort   : " << ms_per_sort(xs, rounds,
+        [&](std::vector<ns::number> & v) {
+            std::stable_sort(v.begin(), v.end(), less);
+        }) << " ms" << std::endl;
+    std::cout << "poly::sort_by_key  : " << ms_per_sort(xs, rounds,
+        [](std::vector<ns::number> & v) {
+            poly::sort_by_key(v, ns::value);
+        }) << " ms" << std::endl;
+}
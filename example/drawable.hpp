@@ -7,8 +7,14 @@
 #define DRAWABLE_HPP_YC42FMI
 
 #include <poly/interface.hpp>
+#include <poly/persistent_vector.hpp>
+#include <atomic>
+#include <memory>
 #include <ostream>
+#include <sstream>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace example {
@@ -30,6 +36,90 @@ void call(draw_, std::vector<T> const& xs, std::ostream& o, std::size_t p) {
     o << std::string(p, ' ') << "</document>" << std::endl;
 }
 
+template <typename T>
+void call(draw_, poly::persistent_vector<T> const& xs,
+          std::ostream& o, std::size_t p)
+{
+    o << std::string(p, ' ') << "<document>" << std::endl;
+    for (auto& x : xs) example::draw(x, o, p + 2);
+    o << std::string(p, ' ') << "</document>" << std::endl;
+}
+
+// A drawable which keeps its last rendering and writes it again until edited.
+// Nested in documents of `cached`, a redraw re-renders only the paths edited
+// through `edit<T>()` or assignment, and splices the kept renderings of the
+// rest. A reference returned by `edit<T>()` must not be used after a redraw.
+// Like other `const` access, drawing is safe from several threads at once:
+// the renderings are swapped in as atomic `shared_ptr`s.
+class cached {
+public:
+    template <typename T, typename = typename std::enable_if<
+        !std::is_same<typename std::decay<T>::type, cached>::value>::type>
+    cached(T && x) : x(std::forward<T>(x)) {}
+
+    cached(cached const & c) : x(c.x), kept(c.load()) {}
+    cached(cached && c) noexcept
+    : x(std::move(c.x)), kept(std::move(c.kept)) {}
+
+    cached & operator=(cached const & c) { return *this = cached(c); }
+    cached & operator=(cached && c) noexcept {
+        x = std::move(c.x);
+        kept = std::move(c.kept);
+        return *this;
+    }
+
+    drawable const & value() const { return x; }
+
+    template <typename T> T & edit() {
+        kept.reset();
+        return x.get<T>();
+    }
+
+    // Whether the next draw renders anew.
+    bool dirty() const { return !load(); }
+
+    friend void call(draw_, cached const & c, std::ostream & o, std::size_t p)
+    {
+        std::shared_ptr<rendering const> r = c.load();
+        if (!r || r->position != p) {
+            r = std::make_shared<rendering const>(rendering{c.render(p), p});
+            std::atomic_store_explicit(&c.kept, r, std::memory_order_release);
+        }
+        o.write(r->text.data(), std::streamsize(r->text.size()));
+    }
+
+private:
+    // Renders into one stream for each level of nesting, reused between nodes.
+    std::string render(std::size_t p) const {
+        static thread_local std::vector<std::unique_ptr<std::ostringstream>>
+            streams;
+        static thread_local std::size_t depth = 0;
+        struct level {
+            level() { ++depth; }
+            ~level() { --depth; }
+        };
+        if (depth == streams.size())
+            streams.emplace_back(new std::ostringstream);
+        std::ostringstream & s = *streams[depth];
+        level l;
+        s.str(std::string());
+        example::draw(x, s, p);
+        return s.str();
+    }
+
+    struct rendering {
+        std::string text;
+        std::size_t position;
+    };
+
+    std::shared_ptr<rendering const> load() const {
+        return std::atomic_load_explicit(&kept, std::memory_order_acquire);
+    }
+
+    drawable x;
+    mutable std::shared_ptr<rendering const> kept;
+};
+
 } // example
 
 #endif // DRAWABLE_HPP_YC42FMI
@@ -29,4 +29,13 @@ int main() {
     std::cout << "--- HERE WE GO: ---" << std::endl;
     example::draw(doc, std::cout, 0);
     std::cout << "--- DONE. ---" << std::endl;
+
+    // Redraw after an edit, rendering only the edited path again.
+    example::cached dashboard = std::vector<example::cached>{
+        1, std::vector<example::cached>{2, 3}, std::string("four")};
+    example::draw(dashboard, std::cout, 0);
+    auto & rows = dashboard.edit<std::vector<example::cached>>();
+    rows[1].edit<std::vector<example::cached>>()[0] = 5;
+    std::cout << "--- AFTER EDIT: ---" << std::endl;
+    example::draw(dashboard, std::cout, 0);
 }
@@ -0,0 +1,328 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_ACTOR_HPP_QX6T0JA
+#define POLY_ACTOR_HPP_QX6T0JA
+
+/// Header <poly/actor.hpp>
+/// =======================
+///
+/// Serialize the calls on an interface value through a mailbox.
+///
+///
+/// Class template `poly::actor<Interface, Executor>`
+/// -------------------------------------------------
+///
+/// Owns a value of type `Interface` and overloads each callable of the
+/// interface for `actor &` in place of `poly::self`. Instead of running
+/// immediately, a call is stored in a message and pushed to the lock-free
+/// mailbox of the actor; the messages are run one at a time, in order, by a
+/// drain task submitted to the executor with `poly::execute(executor, task)`.
+/// Because the owned value is only ever touched from the drain task, no
+/// locking is needed, and any number of threads may call the actor at once.
+///
+/// Calls to signatures returning `void` are fire-and-forget. The others
+/// return a `std::future<R>` which receives the result or the exception.
+///
+///     poly::thread_pool pool(4);
+///     poly::actor<counter> c(pool, 0);
+///     add(c, 1);                           // void(add_, self &, int)
+///     std::future<int> f = value(c);       // int(value_, self const &)
+///     assert(f.get() == 1);
+///
+/// A single drain task runs up to `batch` messages before yielding its thread
+/// back to the executor by resubmitting itself.
+///
+/// **Remark.** Arguments are stored in the message by value, except for
+/// non-const lvalue references, which the caller must keep alive until the
+/// call has run. Exceptions escaping from fire-and-forget calls terminate the
+/// program.
+///
+/// **Remark.** The destructor waits until the mailbox is empty. The actor
+/// itself can be neither copied nor moved.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/interface.hpp>
+#include <poly/thread_pool.hpp>
+#include <poly/detail/indices.hpp>
+#include <poly/detail/signatures_of.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+
+namespace poly {
+
+template <typename Interface, typename Executor=thread_pool> class actor;
+
+namespace detail {
+
+// --- mpsc_queue -------------------------------------------------------------
+
+// Dmitry Vyukov's intrusive multiple producer, single consumer queue. Pushing
+// is wait-free; `pop` may spuriously return null while a push is in progress.
+
+struct mpsc_node {
+    std::atomic<mpsc_node *> next;
+};
+
+class mpsc_queue {
+public:
+    mpsc_queue() noexcept : head(&stub), tail(&stub) { stub.next = nullptr; }
+    mpsc_queue(mpsc_queue const &) = delete;
+    mpsc_queue & operator=(mpsc_queue const &) = delete;
+
+    void push(mpsc_node * n) noexcept {
+        n->next.store(nullptr, std::memory_order_relaxed);
+        mpsc_node * prev = head.exchange(n, std::memory_order_acq_rel);
+        prev->next.store(n, std::memory_order_release);
+    }
+
+    mpsc_node * pop() noexcept {
+        mpsc_node * t = tail;
+        mpsc_node * next = t->next.load(std::memory_order_acquire);
+        if (t == &stub) {
+            if (!next) return nullptr;
+            tail = t = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+        if (next) {
+            tail = next;
+            return t;
+        }
+        if (t != head.load(std::memory_order_acquire)) return nullptr;
+        push(&stub);
+        next = t->next.load(std::memory_order_acquire);
+        if (next) {
+            tail = next;
+            return t;
+        }
+        return nullptr;
+    }
+
+private:
+    std::atomic<mpsc_node *> head;
+    mpsc_node * tail;
+    mpsc_node stub;
+};
+
+// --- actor messages ----------------------------------------------------------
+
+template <typename Interface> struct message : mpsc_node {
+    virtual ~message() = default;
+    virtual void run(Interface & x) = 0;
+};
+
+// How an argument is kept in the message.
+template <typename Arg> struct stored_arg             { typedef Arg type; };
+template <typename Arg> struct stored_arg<Arg &>      { typedef Arg & type; };
+template <typename Arg> struct stored_arg<Arg const &>{ typedef Arg type; };
+template <typename Arg> struct stored_arg<Arg &&>     { typedef Arg type; };
+template <> struct stored_arg<self>                   { typedef self type; };
+template <> struct stored_arg<self &>                 { typedef self type; };
+template <> struct stored_arg<self const &>           { typedef self type; };
+template <> struct stored_arg<self &&>                { typedef self type; };
+
+// How the owned value is passed in place of `poly::self`.
+template <typename Self> struct actor_self {
+    template <typename T> static T & apply(T & x) noexcept { return x; }
+};
+template <> struct actor_self<self &&> {
+    template <typename T> static T && apply(T & x) noexcept {
+        return std::move(x);
+    }
+};
+
+template <typename Interface, typename Sig> struct call_message;
+
+template <typename I, typename R, typename F, typename... Args>
+struct call_message<I, R(F, Args...)> : message<I> {
+    typedef typename self_from<Args...>::type Self;
+    typedef std::tuple<typename stored_arg<Args>::type...> tuple;
+
+    template <typename... A>
+    explicit call_message(A &&... a) : args(std::forward<A>(a)...) {}
+
+    template <std::size_t... N>
+    R apply(I & x, indices<N...>) {
+        return F()(self_to_this(std::get<N>(std::move(args)),
+                                actor_self<Self>::apply(x))...);
+    }
+
+    tuple args;
+};
+
+template <typename I, typename R, typename Sig>
+struct returning_message : call_message<I, Sig> {
+    template <typename... A>
+    explicit returning_message(A &&... a)
+    : call_message<I, Sig>(std::forward<A>(a)...) {}
+
+    virtual void run(I & x) override {
+        POLY_DETAIL_TRY {
+            result.set_value(this->apply(x,
+                typename make_indices<std::tuple_size<
+                    typename call_message<I, Sig>::tuple>::value>::type()));
+        } POLY_DETAIL_CATCH_ALL {
+            result.set_exception(std::current_exception());
+        }
+    }
+
+    std::promise<R> result;
+};
+
+template <typename I, typename Sig>
+struct returning_message<I, void, Sig> : call_message<I, Sig> {
+    template <typename... A>
+    explicit returning_message(A &&... a)
+    : call_message<I, Sig>(std::forward<A>(a)...) {}
+
+    virtual void run(I & x) noexcept override {
+        this->apply(x, typename make_indices<std::tuple_size<
+            typename call_message<I, Sig>::tuple>::value>::type());
+    }
+};
+
+// --- actor_friends<Actor, Signatures...> -------------------------------------
+
+template <typename Arg, typename A>
+struct self_to_actor_                  { typedef Arg type; };
+template <typename A>
+struct self_to_actor_<self, A>         { typedef A & type; };
+template <typename A>
+struct self_to_actor_<self &, A>       { typedef A & type; };
+template <typename A>
+struct self_to_actor_<self const &, A> { typedef A & type; };
+template <typename A>
+struct self_to_actor_<self &&, A>      { typedef A & type; };
+
+template <typename Sig> struct signature_result;
+template <typename R, typename F, typename... Args>
+struct signature_result<R(F, Args...)> { typedef R type; };
+
+template <typename R> struct actor_result { typedef std::future<R> type; };
+template <> struct actor_result<void> { typedef void type; };
+
+template <typename Actor, typename Seq> struct actor_friends;
+
+template <typename A> struct actor_friends<A, seq<>> {};
+
+// Messages run asynchronously, so a `noexcept` signature is posted like any
+// other: only the call on the actor's own thread is known not to throw.
+template <typename A, typename R, typename F, typename... Args
+          POLY_DETAIL_NX_PARAM, typename... Sigs>
+struct actor_friends<A, seq<R(F, Args...) POLY_DETAIL_NX, Sigs...>>
+    : actor_friends<A, seq<Sigs...>>
+{
+    friend typename actor_result<R>::type
+    call(F, typename self_to_actor_<Args, A>::type... args) {
+        A const & a = self_from<Args...>::apply(args...);
+        return post<R(F, Args...)>(const_cast<A &>(a),
+            forward_self<Args>()(std::forward<
+                typename self_to_actor_<Args, A>::type>(args))...);
+    }
+
+    template <typename Sig, typename... X>
+    static typename actor_result<R>::type post(A & a, X &&... x) {
+        return a.template post<Sig>(std::forward<X>(x)...);
+    }
+};
+
+} // detail
+
+// -----------------------------------------------------------------------------
+
+template <typename Interface, typename Executor>
+class actor
+    : public detail::actor_friends<actor<Interface, Executor>,
+          typename detail::signatures_of<Interface>::type>
+{
+    template <typename A, typename Seq> friend struct detail::actor_friends;
+    typedef detail::message<Interface> message;
+
+public:
+    template <typename... Args>
+    explicit actor(Executor & e, Args &&... args)
+    : value(std::forward<Args>(args)...), executor(e), pending(0), batch(64)
+    {}
+
+    actor(actor const &) = delete;
+    actor & operator=(actor const &) = delete;
+
+    ~actor() {
+        while (pending.load(std::memory_order_acquire))
+            std::this_thread::yield();
+    }
+
+    /// The maximum number of messages run by one drain task.
+    void set_batch(std::size_t n) noexcept {
+        batch.store(n ? n : 1, std::memory_order_relaxed);
+    }
+
+private:
+    template <typename Sig, typename... A>
+    typename detail::actor_result<
+        typename detail::signature_result<Sig>::type>::type
+    post(A &&... args) {
+        typedef typename detail::signature_result<Sig>::type R;
+        return post_(new detail::returning_message<Interface, R, Sig>(
+            std::forward<A>(args)...), std::is_void<R>());
+    }
+
+    template <typename Msg>
+    void post_(Msg * m, std::true_type) { enqueue(m); }
+
+    template <typename Msg>
+    auto post_(Msg * m, std::false_type) -> decltype(m->result.get_future()) {
+        auto f = m->result.get_future();
+        enqueue(m);
+        return f;
+    }
+
+    template <typename Msg>
+    void enqueue(Msg * m) {
+        mailbox.push(m);
+        if (pending.fetch_add(1, std::memory_order_acq_rel) == 0)
+            execute(executor, [this] { drain(); });
+    }
+
+    void drain() {
+        std::size_t const limit = batch.load(std::memory_order_relaxed);
+        std::size_t n = pending.load(std::memory_order_acquire);
+        std::size_t done = 0;
+        for (;;) {
+            std::size_t const k = std::min(n, limit - done);
+            for (std::size_t i = 0; i < k; ++i) {
+                detail::mpsc_node * p;
+                while (!(p = mailbox.pop())) std::this_thread::yield();
+                message * m = static_cast<message *>(p);
+                m->run(value);
+                delete m;
+            }
+            done += k;
+            n = pending.fetch_sub(k, std::memory_order_acq_rel) - k;
+            if (n == 0) return;
+            if (done >= limit) {
+                execute(executor, [this] { drain(); });
+                return;
+            }
+        }
+    }
+
+    Interface value;
+    Executor & executor;
+    detail::mpsc_queue mailbox;
+    std::atomic<std::size_t> pending;
+    std::atomic<std::size_t> batch;
+};
+
+} // poly
+
+#endif // POLY_ACTOR_HPP_QX6T0JA
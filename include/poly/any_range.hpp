@@ -0,0 +1,266 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_ANY_RANGE_HPP_H5CW7LP
+#define POLY_ANY_RANGE_HPP_H5CW7LP
+
+/// Header <poly/any_range.hpp>
+/// ===========================
+///
+/// Type-erased, single-pass ranges which cross the virtual boundary once per
+/// chunk of elements rather than once per element.
+///
+///
+/// Class template `poly::any_range<T, ChunkSize>`
+/// ----------------------------------------------
+///
+/// A single-pass input range of `T`, e.g. `int` or an interface type, built
+/// from any source of `T`s. Whenever it runs out of elements, it asks the
+/// source, through one virtual call, to construct up to `ChunkSize` (by
+/// default 64) more into a buffer of its own. Iterating over the buffer is a
+/// plain loop, so the cost of the erasure is shared by a whole chunk.
+///
+///     poly::any_range<example::drawable> shapes = load_shapes(file);
+///     for (auto & s : shapes) draw(s, out);
+///
+/// The source can be
+///
+/// - any range with `std::begin` and `std::end`, whose elements are copied
+///   into the chunks. An lvalue range is referred to, and must outlive the
+///   `any_range`; an rvalue range is moved into it;
+/// - any object `s` for which `call(poly::next_chunk_, s, out, n)` constructs
+///   at most `n` values at `T * out` and returns how many, `0` meaning the
+///   end. If it throws, it must first destroy the values it constructed.
+///
+/// `for_each(f)` calls `f(x)` for every remaining element, and
+/// `for_each_chunk(f)` calls `f(first, last)` for every remaining chunk, both
+/// without the end checks of the iterators.
+///
+/// **Remark.** The elements of a chunk are destroyed when the next one is
+/// fetched, so references to them are only valid until then. They may be
+/// moved from.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/callable.hpp>
+#include <poly/detail/config.hpp>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace poly {
+
+POLY_CALLABLE(next_chunk);
+
+namespace detail {
+
+// --- range_source<R, T> ------------------------------------------------------
+
+// Fills chunks by copying the elements of a range.
+template <typename R, typename T> struct range_source {
+    typedef decltype(std::begin(std::declval<R &>())) iterator;
+
+    explicit range_source(R && r)
+    : r(std::forward<R>(r)), it(std::begin(this->r)), last(std::end(this->r))
+    {}
+
+    friend std::size_t call(next_chunk_, range_source & s,
+                            T * out, std::size_t n)
+    {
+        std::size_t k = 0;
+        POLY_DETAIL_TRY {
+            for (; k < n && s.it != s.last; ++k, ++s.it)
+                ::new (static_cast<void *>(out + k)) T(*s.it);
+        } POLY_DETAIL_CATCH_ALL {
+            while (k) out[--k].~T();
+            POLY_DETAIL_RETHROW;
+        }
+        return k;
+    }
+
+    R r;
+    iterator it;
+    iterator last;
+};
+
+template <typename S, typename T, typename Enable=void>
+struct is_chunk_source : std::false_type {};
+
+template <typename S, typename T>
+struct is_chunk_source<S, T, typename std::enable_if<std::is_convertible<
+    decltype(call(std::declval<next_chunk_ const &>(), std::declval<S &>(),
+                  std::declval<T *>(), std::size_t())),
+    std::size_t>::value>::type> : std::true_type {};
+
+// An rvalue source is owned; an lvalue range is referred to.
+template <typename S, typename T, typename Enable=void>
+struct chunk_source {
+    typedef range_source<S, T> type;
+};
+
+template <typename S, typename T>
+struct chunk_source<S, T, typename std::enable_if<
+    is_chunk_source<typename std::decay<S>::type, T>::value>::type>
+{
+    typedef typename std::decay<S>::type type;
+};
+
+} // detail
+
+template <typename T, std::size_t ChunkSize=64>
+class any_range {
+    static_assert(ChunkSize > 0, "chunks can't be empty");
+
+    struct concept_type {
+        virtual ~concept_type() = default;
+        virtual std::size_t fill(T * out, std::size_t n) = 0;
+    };
+
+    template <typename S>
+    struct model : concept_type {
+        template <typename A>
+        explicit model(A && a) : s(std::forward<A>(a)) {}
+        virtual std::size_t fill(T * out, std::size_t n) override {
+            return call(next_chunk_(), s, out, n);
+        }
+        S s;
+    };
+
+    typedef typename std::aligned_storage<sizeof(T), alignof(T)>::type slot;
+
+public:
+    static constexpr std::size_t chunk_size = ChunkSize;
+
+    typedef T value_type;
+    typedef T & reference;
+
+    class iterator {
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef T * pointer;
+        typedef T & reference;
+
+        iterator() noexcept : r(nullptr) {}
+
+        T & operator*() const noexcept { return r->data()[r->pos]; }
+        T * operator->() const noexcept { return r->data() + r->pos; }
+
+        iterator & operator++() {
+            if (++r->pos == r->count && !r->refill()) r = nullptr;
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(iterator a, iterator b) noexcept {
+            return a.r == b.r;
+        }
+        friend bool operator!=(iterator a, iterator b) noexcept {
+            return a.r != b.r;
+        }
+
+    private:
+        friend class any_range;
+        explicit iterator(any_range * r) noexcept : r(r) {}
+        any_range * r;
+    };
+
+    any_range() noexcept : pos(0), count(0), started(true) {}
+
+    template <typename S, typename Enable=typename std::enable_if<
+        !std::is_same<typename std::decay<S>::type, any_range>::value
+        >::type>
+    any_range(S && s)
+    : p(new model<typename detail::chunk_source<S, T>::type>(
+          std::forward<S>(s)))
+    , buf(new slot[ChunkSize]), pos(0), count(0), started(false)
+    {}
+
+    any_range(any_range && x) noexcept
+    : p(std::move(x.p)), buf(std::move(x.buf))
+    , pos(x.pos), count(x.count), started(x.started)
+    {
+        x.pos = x.count = 0;
+        x.started = true;
+    }
+
+    any_range & operator=(any_range && x) noexcept {
+        if (this != &x) {
+            clear();
+            p = std::move(x.p);
+            buf = std::move(x.buf);
+            pos = x.pos;
+            count = x.count;
+            started = x.started;
+            x.pos = x.count = 0;
+            x.started = true;
+        }
+        return *this;
+    }
+
+    ~any_range() { clear(); }
+
+    iterator begin() {
+        return ready() ? iterator(this) : iterator();
+    }
+    iterator end() noexcept { return iterator(); }
+
+    template <typename F> void for_each_chunk(F f) {
+        while (ready()) {
+            T * first = data();
+            std::size_t i = pos;
+            pos = count;
+            f(first + i, first + count);
+        }
+    }
+
+    template <typename F> void for_each(F f) {
+        for_each_chunk([&f](T * first, T * last) {
+            for (; first != last; ++first) f(*first);
+        });
+    }
+
+private:
+    T * data() const noexcept { return reinterpret_cast<T *>(buf.get()); }
+
+    // True if there is an element at `pos`, fetching a new chunk if needed.
+    bool ready() {
+        if (!started) {
+            started = true;
+            return refill();
+        }
+        return pos != count || refill();
+    }
+
+    bool refill() {
+        clear();
+        if (p) count = p->fill(data(), ChunkSize);
+        if (count == 0) p.reset();
+        return count != 0;
+    }
+
+    void clear() noexcept {
+        T * d = data();
+        for (std::size_t i = 0; i < count; ++i) d[i].~T();
+        pos = count = 0;
+    }
+
+    std::unique_ptr<concept_type> p;
+    std::unique_ptr<slot[]> buf;
+    std::size_t pos;
+    std::size_t count;
+    bool started;
+};
+
+template <typename T, std::size_t ChunkSize>
+constexpr std::size_t any_range<T, ChunkSize>::chunk_size;
+
+} // poly
+
+#endif // POLY_ANY_RANGE_HPP_H5CW7LP
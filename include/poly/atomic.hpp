@@ -0,0 +1,276 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_ATOMIC_HPP_R4TW9EZ
+#define POLY_ATOMIC_HPP_R4TW9EZ
+
+/// Header <poly/atomic.hpp>
+/// ========================
+///
+/// Interface values which are read all the time and replaced now and then.
+///
+///
+/// Class template `poly::atomic<Interface>`
+/// ----------------------------------------
+///
+/// Holds a value of the interface type `Interface`, e.g. a routing strategy,
+/// which any number of threads read while others replace it:
+///
+///     poly::atomic<router> current(round_robin{});
+///
+///     // On every request.
+///     auto r = current.load();
+///     send(route(*r, request), request);
+///
+///     // Now and then.
+///     current.store(least_loaded{stats});
+///
+/// `load()` returns a `snapshot`, which pins the value held at that time:
+/// it stays alive, and unchanged, until the snapshot is destroyed, however
+/// many times the value is replaced meanwhile. Dereference it to call the
+/// `self const &` signatures of the interface. Reading takes no locks, and
+/// finishes in a bounded number of steps however busy the writers are.
+///
+/// `store(x)` makes `x` the value seen by the following `load()` calls. The
+/// value it replaces is destroyed once no snapshot can refer to it anymore:
+/// during a later `store()`, on any `poly::atomic`, or when the
+/// `poly::atomic` itself is destroyed. Writers briefly take a lock shared by
+/// all `poly::atomic` objects.
+///
+/// **Remark.** A snapshot must be destroyed on the thread which loaded it, and
+/// should be short-lived: while it is alive, no value replaced after it was
+/// taken, in any `poly::atomic`, can be destroyed.
+///
+///
+/// Reclamation
+/// -----------
+///
+/// Replaced values are reclaimed by epochs. There is a global epoch counter,
+/// and each reading thread announces the epoch it saw while it holds any
+/// snapshots. A replaced value is tagged with the epoch at which it was
+/// replaced, and the epoch is only advanced once every reading thread has
+/// announced the current one. Thus, two epochs later, no thread can still
+/// refer to the value.
+
+// -----------------------------------------------------------------------------
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace poly {
+
+namespace detail {
+
+// The epoch announced by one reading thread, 0 if it holds no snapshots.
+struct epoch_slot {
+    epoch_slot() : epoch(0), next(nullptr), used(true) {}
+    std::atomic<std::uint64_t> epoch;
+    epoch_slot * next;
+    std::atomic<bool> used;
+    // Keep the announcements of different threads in different cache lines.
+    char padding[128];
+};
+
+struct retired_item {
+    void * p;
+    void (*destroy)(void *);
+    std::uint64_t epoch;
+};
+
+class epoch_domain {
+public:
+    // Null once the domain has been destroyed, at exit.
+    static epoch_domain * instance() {
+        if (destroyed()) return nullptr;
+        static epoch_domain d;
+        return &d;
+    }
+
+    ~epoch_domain() {
+        for (auto const & r : retired) r.destroy(r.p);
+        while (epoch_slot * s = slots) {
+            slots = s->next;
+            delete s;
+        }
+        destroyed() = true;
+    }
+
+    // Announce the current epoch for the slot `s`.
+    void pin(epoch_slot & s) noexcept {
+        s.epoch.store(epoch.load());
+    }
+
+    void unpin(epoch_slot & s) noexcept {
+        s.epoch.store(0, std::memory_order_release);
+    }
+
+    // Claim a slot for the calling thread, reusing one of an exited thread.
+    epoch_slot * acquire() {
+        std::lock_guard<std::mutex> lock(m);
+        for (epoch_slot * s = slots; s; s = s->next) {
+            bool free = false;
+            if (s->used.compare_exchange_strong(free, true)) return s;
+        }
+        epoch_slot * s = new epoch_slot();
+        s->next = slots;
+        slots = s;
+        return s;
+    }
+
+    void release(epoch_slot * s) noexcept {
+        s->epoch.store(0);
+        s->used.store(false);
+    }
+
+    // Destroy `p` with `destroy(p)` once no thread can refer to it.
+    void retire(void * p, void (*destroy)(void *)) {
+        std::vector<retired_item> ready;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            retired.push_back(retired_item{p, destroy, epoch.load()});
+            // Without readers in the way, two steps free `p` right away.
+            advance();
+            advance();
+            std::uint64_t const e = epoch.load();
+            auto last = retired.begin();
+            for (auto it = retired.begin(); it != retired.end(); ++it) {
+                if (it->epoch + 2 <= e) ready.push_back(*it);
+                else *last++ = *it;
+            }
+            retired.erase(last, retired.end());
+        }
+        for (auto const & r : ready) r.destroy(r.p);
+    }
+
+private:
+    epoch_domain() : epoch(1), slots(nullptr) {}
+
+    // Step the epoch if every reading thread has seen the current one.
+    void advance() noexcept {
+        std::uint64_t const e = epoch.load();
+        for (epoch_slot * s = slots; s; s = s->next) {
+            std::uint64_t const a = s->epoch.load();
+            if (a != 0 && a != e) return;
+        }
+        epoch.store(e + 1);
+    }
+
+    static bool & destroyed() noexcept {
+        static bool d = false;
+        return d;
+    }
+
+    std::atomic<std::uint64_t> epoch;
+    std::mutex m;
+    epoch_slot * slots;
+    std::vector<retired_item> retired;
+};
+
+// The slot of the current thread, and how many snapshots it holds.
+class epoch_pin {
+public:
+    static epoch_pin & instance() {
+        static thread_local epoch_pin p;
+        return p;
+    }
+
+    ~epoch_pin() {
+        if (epoch_domain * d = epoch_domain::instance()) d->release(slot);
+    }
+
+    void enter() noexcept {
+        if (depth++ == 0) domain->pin(*slot);
+    }
+
+    void leave() noexcept {
+        if (--depth == 0) domain->unpin(*slot);
+    }
+
+private:
+    epoch_pin()
+    : domain(epoch_domain::instance()), slot(domain->acquire()), depth(0) {}
+
+    epoch_domain * domain;
+    epoch_slot * slot;
+    std::size_t depth;
+};
+
+template <typename T> void delete_retired(void * p) {
+    delete static_cast<T *>(p);
+}
+
+} // detail
+
+template <typename Interface>
+class atomic {
+    struct node {
+        explicit node(Interface && x) : value(std::move(x)) {}
+        Interface value;
+    };
+
+public:
+    class snapshot {
+    public:
+        snapshot(snapshot && x) noexcept : pin(x.pin), p(x.p) {
+            x.pin = nullptr;
+        }
+        snapshot(snapshot const &) = delete;
+        snapshot & operator=(snapshot const &) = delete;
+
+        ~snapshot() {
+            if (pin) pin->leave();
+        }
+
+        Interface const & operator*() const noexcept { return p->value; }
+        Interface const * operator->() const noexcept { return &p->value; }
+
+    private:
+        friend class atomic;
+        snapshot(detail::epoch_pin & e, std::atomic<node *> const & a)
+        noexcept
+        : pin(&e)
+        {
+            e.enter();
+            p = a.load();
+        }
+
+        detail::epoch_pin * pin;
+        node const * p;
+    };
+
+    atomic() : p(new node(Interface())) {}
+    explicit atomic(Interface x) : p(new node(std::move(x))) {}
+
+    atomic(atomic const &) = delete;
+    atomic & operator=(atomic const &) = delete;
+
+    ~atomic() { retire(p.load()); }
+
+    snapshot load() const {
+        return snapshot(detail::epoch_pin::instance(), p);
+    }
+
+    void store(Interface x) {
+        retire(p.exchange(new node(std::move(x))));
+    }
+
+private:
+    static void retire(node * n) {
+        if (detail::epoch_domain * d = detail::epoch_domain::instance())
+            d->retire(n, &detail::delete_retired<node>);
+        else
+            delete n;
+    }
+
+    std::atomic<node *> p;
+};
+
+} // poly
+
+#endif // POLY_ATOMIC_HPP_R4TW9EZ
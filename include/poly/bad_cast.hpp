@@ -16,7 +16,8 @@
 /// --------------------------------
 ///
 /// Thrown when `poly::cast<T>(x)` fails for a non-pointer `x`. Inherits
-/// `std::bad_cast`.
+/// `std::bad_cast`. Without exceptions, passed to the failure handler of
+/// <poly/failure.hpp> instead.
 
 #include <typeinfo>
 
@@ -0,0 +1,211 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_CONSTANT_HPP_K7ZD4UM
+#define POLY_CONSTANT_HPP_K7ZD4UM
+
+/// Header <poly/constant.hpp>
+/// ==========================
+///
+/// Interfaces to constant objects, built at compile time.
+///
+///
+/// Class template `poly::constant_ref<Interface>`
+/// ----------------------------------------------
+///
+/// A non-owning reference to a `const` object of any type implementing the
+/// signatures of `Interface`, together with a table of function pointers for
+/// the type. Both are `constexpr`: when the object has static storage
+/// duration, a `constant_ref` to it is a constant expression, and tables of
+/// them are initialized at compile time and can be placed in read-only data,
+/// with no code run at startup.
+///
+///     struct handler : poly::interface<handler
+///         , bool(parse_, poly::self const &, std::string const &)
+///         > { POLY_INTERFACE_CONSTRUCTORS(handler); };
+///
+///     constexpr int_parser ints{};
+///     constexpr hex_parser hexes{16};
+///     constexpr poly::constant_ref<handler> handlers[] = {ints, hexes};
+///
+///     parse(handlers[1], "ff");
+///
+/// Only the signatures taking `poly::self const &` or `poly::self` (a copy of
+/// the referred object) are callable through a `constant_ref`; the calls
+/// themselves are made at run time, through one function pointer.
+///
+/// **Remark.** Copying a `constant_ref` copies the reference, not the object.
+/// It cannot be made to refer to a temporary.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/callable.hpp>
+#include <poly/detail/self.hpp>
+#include <poly/detail/seq.hpp>
+#include <poly/detail/signatures_of.hpp>
+#include <poly/detail/type_tag.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace poly {
+
+template <typename Interface> class constant_ref;
+
+namespace detail {
+
+// --- constant_vtable<Signatures...> ------------------------------------------
+
+template <typename Sig> struct constant_entry;
+template <typename R, typename F, typename... Args POLY_DETAIL_NX_PARAM>
+struct constant_entry<R(F, Args...) POLY_DETAIL_NX> {
+    typedef R (*pointer)(void const *, F, Args...) POLY_DETAIL_NX;
+    constexpr explicit constant_entry(pointer fn) : fn(fn) {}
+    pointer fn;
+};
+
+template <typename Seq> struct constant_vtable;
+template <typename... Sigs>
+struct constant_vtable<seq<Sigs...>> : constant_entry<Sigs>... {
+    constexpr constant_vtable(type_id const * tag,
+                              typename constant_entry<Sigs>::pointer... fns)
+    : constant_entry<Sigs>(fns)..., tag(tag) {}
+    type_id const * tag;
+};
+
+// Only the signatures taking `self const &` or `self` get a function; the
+// others are left null and have no friend `call` either.
+template <typename T, typename Sig,
+          typename Self=typename self_from_signature<Sig>::type>
+struct constant_thunk {
+    static constexpr typename constant_entry<Sig>::pointer get() {
+        return nullptr;
+    }
+};
+
+template <typename T, typename R, typename F, typename... Args
+          POLY_DETAIL_NX_PARAM>
+struct constant_thunk<T, R(F, Args...) POLY_DETAIL_NX, self const &> {
+    typedef R (*pointer)(void const *, F, Args...) POLY_DETAIL_NX;
+    static R apply(void const * p, F f, Args... args) POLY_DETAIL_NX {
+        return call(f, self_to_this(std::forward<Args>(args),
+                                    *static_cast<T const *>(p))...);
+    }
+    static constexpr pointer get() { return &apply; }
+};
+
+template <typename T, typename R, typename F, typename... Args
+          POLY_DETAIL_NX_PARAM>
+struct constant_thunk<T, R(F, Args...) POLY_DETAIL_NX, self>
+    : constant_thunk<T, R(F, Args...) POLY_DETAIL_NX, self const &> {};
+
+template <typename T, typename Seq> struct constant_vtable_for;
+template <typename T, typename... Sigs>
+struct constant_vtable_for<T, seq<Sigs...>> {
+    static constexpr constant_vtable<seq<Sigs...>> value{
+        &type_tag<T>::id, constant_thunk<T, Sigs>::get()...};
+};
+
+template <typename T, typename... Sigs>
+constexpr constant_vtable<seq<Sigs...>>
+constant_vtable_for<T, seq<Sigs...>>::value;
+
+// --- constant_friends<C, Signatures> -----------------------------------------
+
+struct constant_access {
+    template <typename Sig, typename C, typename... Args>
+    static auto dispatch(C const & c, Args &&... args)
+    -> decltype(static_cast<constant_entry<Sig> const &>(*c.vt).fn(
+           c.p, std::forward<Args>(args)...))
+    {
+        return static_cast<constant_entry<Sig> const &>(*c.vt).fn(
+            c.p, std::forward<Args>(args)...);
+    }
+
+    // A reference to an object whose table was looked up at run time, e.g.
+    // from a type id (see <poly/shared.hpp>).
+    template <typename C>
+    static C make(void const * p, typename C::vtable const * vt) noexcept {
+        C c;
+        c.p = p;
+        c.vt = vt;
+        return c;
+    }
+};
+
+template <typename C, typename Sig,
+          typename Self=typename self_from_signature<Sig>::type>
+struct constant_friend {};
+
+template <typename C, typename R, typename F, typename... Args
+          POLY_DETAIL_NX_PARAM>
+struct constant_friend<C, R(F, Args...) POLY_DETAIL_NX, self const &> {
+    friend R call(F f, typename self_to_this_<Args, C>::type... args)
+    POLY_DETAIL_NX
+    {
+        return constant_access::dispatch<R(F, Args...) POLY_DETAIL_NX>(
+            self_from<Args...>::apply(args...), f,
+            forward_self<Args>()(args)...);
+    }
+};
+
+template <typename C, typename R, typename F, typename... Args
+          POLY_DETAIL_NX_PARAM>
+struct constant_friend<C, R(F, Args...) POLY_DETAIL_NX, self>
+    : constant_friend<C, R(F, Args...) POLY_DETAIL_NX, self const &> {};
+
+template <typename C, typename Seq> struct constant_friends;
+template <typename C> struct constant_friends<C, seq<>> {};
+template <typename C, typename Sig, typename... Sigs>
+struct constant_friends<C, seq<Sig, Sigs...>>
+    : constant_friend<C, Sig>, constant_friends<C, seq<Sigs...>> {};
+
+} // detail
+
+// -----------------------------------------------------------------------------
+
+template <typename Interface>
+class constant_ref
+    : public detail::constant_friends<constant_ref<Interface>,
+          typename detail::signatures_of<Interface>::type>
+{
+    typedef typename detail::signatures_of<Interface>::type signatures;
+    typedef detail::constant_vtable<signatures> vtable;
+
+    friend struct detail::constant_access;
+
+public:
+    constexpr constant_ref() noexcept : p(nullptr), vt(nullptr) {}
+
+    template <typename T>
+    constexpr constant_ref(T const & x) noexcept
+    : p(&x), vt(&detail::constant_vtable_for<T, signatures>::value) {}
+
+    // Would refer to a temporary.
+    template <typename T, typename Enable=typename std::enable_if<
+        !std::is_same<T, constant_ref>::value>::type>
+    constant_ref(T const &&) = delete;
+
+    constexpr bool valid() const noexcept { return vt != nullptr; }
+    constexpr explicit operator bool() const noexcept { return valid(); }
+
+#ifndef POLY_NO_RTTI
+    std::type_info const & type() const noexcept {
+        return vt ? *vt->tag->info : typeid(void);
+    }
+#endif
+
+    template <typename T> T const * target() const noexcept {
+        return vt && vt->tag == &detail::type_tag<T>::id
+            ? static_cast<T const *>(p) : nullptr;
+    }
+
+private:
+    void const * p;
+    vtable const * vt;
+};
+
+} // poly
+
+#endif // POLY_CONSTANT_HPP_K7ZD4UM
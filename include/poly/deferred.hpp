@@ -0,0 +1,252 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_DEFERRED_HPP_N8VK3QS
+#define POLY_DEFERRED_HPP_N8VK3QS
+
+/// Header <poly/deferred.hpp>
+/// ==========================
+///
+/// Destruction of interface models on a background thread.
+///
+///
+/// Class template `poly::is_deferred<T>`
+/// -------------------------------------
+///
+/// Specialize as `std::true_type` to destroy the models of interfaces holding
+/// a `T` on the background reclaimer thread, instead of on the thread which
+/// drops the last interface:
+///
+///     #include <poly/deferred.hpp>
+///
+///     namespace poly {
+///         template <> struct is_deferred<document> : std::true_type {};
+///     }
+///
+/// The specialization must be visible before the first model of `T` is
+/// instantiated. Good candidates are types whose destruction is slow and
+/// whose destructors don't care which thread they run on, such as large
+/// nested containers of interfaces.
+///
+///
+/// The reclaimer
+/// -------------
+///
+/// Each thread collects the models it drops into a batch, and hands the
+/// batch to the reclaimer once it has `deferred_batch` models, when
+/// `flush_deferred()` is called, or when the thread exits. The reclaimer
+/// thread is started on first use and destroys the batches in order.
+/// Anything dropped by the destructors it runs is destroyed right there, on
+/// the same thread.
+///
+/// At most `deferred_queue_size` batches wait at a time. Beyond that, or if
+/// memory for the batch can't be allocated, models are destroyed
+/// synchronously on the thread which drops them, so that a thread producing
+/// garbage faster than the reclaimer destroys it is slowed down instead of
+/// running out of memory.
+///
+/// **Remark.** A model may wait in the batch of its thread until the batch is
+/// full. Call `flush_deferred()` after dropping a large value to get it going.
+///
+///
+/// Functions `poly::flush_deferred()`, `poly::drain_deferred()`
+/// ------------------------------------------------------------
+///
+/// `flush_deferred()` hands the batch of the current thread to the reclaimer.
+/// `drain_deferred()` does the same, then waits until the reclaimer has
+/// destroyed every batch queued so far.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/detail/allocate.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace poly {
+
+static constexpr std::size_t deferred_batch = 64;
+static constexpr std::size_t deferred_queue_size = 1024;
+
+namespace detail {
+
+struct deferred_item {
+    void * p;
+    void (*destroy)(void *);
+};
+
+typedef std::vector<deferred_item> deferred_list;
+
+inline void destroy_all(deferred_list & l) noexcept {
+    for (auto const & i : l) i.destroy(i.p);
+    l.clear();
+}
+
+// True on the reclaimer thread.
+inline bool & on_reclaimer() noexcept {
+    static thread_local bool r = false;
+    return r;
+}
+
+// The queue of batches, and the thread destroying them.
+class reclaimer {
+public:
+    // Null once the reclaimer has been destroyed, at exit.
+    static reclaimer * instance() {
+        if (destroyed()) return nullptr;
+        static reclaimer r;
+        return &r;
+    }
+
+    ~reclaimer() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopping = true;
+        }
+        ready.notify_one();
+        if (worker.joinable()) worker.join();
+        destroyed() = true;
+    }
+
+    // Queue the batch `b`, or return false if the queue is full.
+    bool put(deferred_list & b) noexcept {
+        std::unique_lock<std::mutex> lock(m);
+        if (stopping || queue.size() >= deferred_queue_size) return false;
+        POLY_DETAIL_TRY {
+            if (!worker.joinable())
+                worker = std::thread(&reclaimer::run, this);
+            queue.push_back(std::move(b));
+        } POLY_DETAIL_CATCH_ALL {
+            return false;
+        }
+        ++pending;
+        lock.unlock();
+        ready.notify_one();
+        return true;
+    }
+
+    // Wait until every batch queued so far has been destroyed.
+    void drain() {
+        std::unique_lock<std::mutex> lock(m);
+        idle.wait(lock, [this] { return pending == 0; });
+    }
+
+private:
+    reclaimer() : pending(0), stopping(false) {}
+
+    void run() noexcept {
+        on_reclaimer() = true;
+        std::unique_lock<std::mutex> lock(m);
+        for (;;) {
+            ready.wait(lock, [this] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            deferred_list b = std::move(queue.front());
+            queue.pop_front();
+            lock.unlock();
+            // Let the thread which woke us get on with its work first.
+            std::this_thread::yield();
+            destroy_all(b);
+            lock.lock();
+            if (--pending == 0) idle.notify_all();
+        }
+    }
+
+    static bool & destroyed() noexcept {
+        static bool d = false;
+        return d;
+    }
+
+    std::mutex m;
+    std::condition_variable ready;
+    std::condition_variable idle;
+    std::deque<deferred_list> queue;
+    std::size_t pending;
+    bool stopping;
+    std::thread worker;
+};
+
+// The batch of the current thread.
+class deferred_cache {
+public:
+    // Null once the cache of the current thread has been destroyed.
+    static deferred_cache * instance() {
+        if (destroyed()) return nullptr;
+        static thread_local deferred_cache c;
+        return &c;
+    }
+
+    ~deferred_cache() {
+        destroyed() = true;
+        flush();
+    }
+
+    // Add `i` to the batch, or return false if there is no memory for it.
+    bool add(deferred_item i) noexcept {
+        POLY_DETAIL_TRY {
+            if (batch.capacity() == 0) batch.reserve(deferred_batch);
+            batch.push_back(i);
+        } POLY_DETAIL_CATCH_ALL {
+            return false;
+        }
+        if (batch.size() >= deferred_batch) flush();
+        return true;
+    }
+
+    void flush() noexcept {
+        if (batch.empty()) return;
+        // Models destroyed below may add more to a new batch.
+        deferred_list b;
+        b.swap(batch);
+        reclaimer * r = reclaimer::instance();
+        if (!r || !r->put(b)) destroy_all(b);
+    }
+
+private:
+    static bool & destroyed() noexcept {
+        static thread_local bool d = false;
+        return d;
+    }
+
+    deferred_list batch;
+};
+
+template <typename M> void delete_model(void * p) {
+    delete static_cast<M *>(p);
+}
+
+inline void deferred_delete(void * p, void (*destroy)(void *)) noexcept {
+    if (!on_reclaimer()) {
+        if (deferred_cache * c = deferred_cache::instance())
+            if (c->add(deferred_item{p, destroy})) return;
+    }
+    destroy(p);
+}
+
+template <typename T> struct model_disposer<T, true> {
+    template <typename M>
+    static void dispose(M * m) noexcept {
+        deferred_delete(m, &delete_model<M>);
+    }
+};
+
+} // detail
+
+inline void flush_deferred() noexcept {
+    if (detail::deferred_cache * c = detail::deferred_cache::instance())
+        c->flush();
+}
+
+inline void drain_deferred() {
+    flush_deferred();
+    if (detail::reclaimer * r = detail::reclaimer::instance()) r->drain();
+}
+
+} // poly
+
+#endif // POLY_DEFERRED_HPP_N8VK3QS
@@ -0,0 +1,75 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_DETAIL_ALLOCATE_HPP_T6QK2MB
+#define POLY_DETAIL_ALLOCATE_HPP_T6QK2MB
+
+#include <poly/failure.hpp>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+namespace poly {
+
+// --- is_pooled<T> ------------------------------------------------------------
+
+// Specialize as true to allocate the models of `T` from <poly/pool.hpp>.
+template <typename T> struct is_pooled : std::false_type {};
+
+// --- is_deferred<T> ----------------------------------------------------------
+
+// Specialize as true to destroy the models of `T` on the background thread of
+// <poly/deferred.hpp>.
+template <typename T> struct is_deferred : std::false_type {};
+
+namespace detail {
+
+// --- model_allocator<T> ------------------------------------------------------
+
+template <typename T, bool Pooled = is_pooled<T>::value>
+struct model_allocator {
+    static void * allocate(std::size_t n) { return detail::allocate(n); }
+    static void deallocate(void * p, std::size_t) noexcept {
+        ::operator delete(p);
+    }
+};
+
+// Defined in <poly/pool.hpp>.
+template <typename T> struct model_allocator<T, true>;
+
+// --- model_disposer<T> -------------------------------------------------------
+
+template <typename T, bool Deferred = is_deferred<T>::value>
+struct model_disposer;
+
+// Defined in <poly/deferred.hpp>.
+template <typename T> struct model_disposer<T, true>;
+
+// --- disposing<T, Model, Concept> --------------------------------------------
+
+// Base of the models of `T`. Only those of deferred types override the
+// `dispose()` of `Concept`, which deletes the model; the rest share it.
+
+template <typename T, typename M, typename C,
+          bool Deferred = is_deferred<T>::value>
+struct disposing : C {};
+
+template <typename T, typename M, typename C>
+struct disposing<T, M, C, true> : C {
+    virtual void dispose() noexcept override {
+        model_disposer<T>::dispose(static_cast<M *>(this));
+    }
+};
+
+// Deletes a model through `dispose()`, which some models override.
+struct model_deleter {
+    template <typename M>
+    void operator()(M * m) const noexcept { m->dispose(); }
+};
+
+} // detail
+} // poly
+
+#endif // POLY_DETAIL_ALLOCATE_HPP_T6QK2MB
@@ -0,0 +1,88 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_DETAIL_CAPABILITIES_HPP_E6WR1NB
+#define POLY_DETAIL_CAPABILITIES_HPP_E6WR1NB
+
+#include <poly/constant.hpp>
+#include <poly/detail/signatures_of.hpp>
+#include <poly/detail/type_tag.hpp>
+#include <cstddef>
+
+namespace poly {
+
+template <typename... Interfaces> struct implements {};
+
+template <typename T> struct capabilities : implements<> {};
+
+namespace detail {
+
+// --- capabilities_of<T>::value -----------------------------------------------
+
+// The interfaces `T` declares in `poly::capabilities<T>`, each with the table
+// of functions a `poly::constant_ref` to a `T` uses for it. Built at compile
+// time, when a model of `T` is first instantiated.
+
+struct capability {
+    void const * key;    // &type_tag<Interface>::id
+    void const * table;  // constant_vtable for the signatures of Interface
+};
+
+struct capability_table {
+    capability const * entries;
+    std::size_t size;
+
+    void const * find(void const * key) const noexcept {
+        for (std::size_t i = 0; i < size; ++i)
+            if (entries[i].key == key) return entries[i].table;
+        return nullptr;
+    }
+};
+
+template <typename T, typename Implements> struct capabilities_for;
+template <typename T, typename... Is>
+struct capabilities_for<T, implements<Is...>> {
+    // One extra entry, so that the array is never empty.
+    static constexpr capability entries[sizeof...(Is) + 1] = {
+        {&type_tag<Is>::id, &constant_vtable_for<T,
+            typename signatures_of<Is>::type>::value}...,
+        {nullptr, nullptr}};
+    static constexpr capability_table value = {entries, sizeof...(Is)};
+};
+
+template <typename T, typename... Is>
+constexpr capability capabilities_for<T, implements<Is...>>::entries[];
+template <typename T, typename... Is>
+constexpr capability_table capabilities_for<T, implements<Is...>>::value;
+
+// The `implements<Interfaces...>` base of `poly::capabilities<T>`.
+template <typename... Is>
+implements<Is...> implements_base(implements<Is...> const *);
+
+template <typename T>
+struct capabilities_of
+    : capabilities_for<T, decltype(implements_base(
+          static_cast<capabilities<T> const *>(nullptr)))> {};
+
+// --- model_info_of<T>::value -------------------------------------------------
+
+// What the models of `T` report about `T`, through a single virtual call.
+
+struct model_info {
+    type_id const * tag;
+    capability_table const * capabilities;
+};
+
+template <typename T> struct model_info_of {
+    static constexpr model_info value = {
+        &type_tag<T>::id, &capabilities_of<T>::value};
+};
+
+template <typename T> constexpr model_info model_info_of<T>::value;
+
+} // detail
+} // poly
+
+#endif // POLY_DETAIL_CAPABILITIES_HPP_E6WR1NB
@@ -6,9 +6,57 @@
 #ifndef POLY_DETAIL_CONFIG_HPP_0GP7OI1
 #define POLY_DETAIL_CONFIG_HPP_0GP7OI1
 
-#if defined(__GNUC__) && !defined(__clang__)
-#define POLY_NO_MULTIPLE_INHERITANCE
+// Ref-qualified member functions (`f() &&`) arrived in Clang 2.9, GCC 4.8.1
+// and MSVC 2015. Define `POLY_NO_REF_QUALIFIERS` to do without them anyway.
+#ifndef POLY_NO_REF_QUALIFIERS
+#if defined(__clang__)
+#if !__has_feature(cxx_reference_qualified_functions)
 #define POLY_NO_REF_QUALIFIERS
 #endif
+#elif defined(__GNUC__)
+#if __GNUC__ * 10000 + __GNUC_MINOR__ * 100 + __GNUC_PATCHLEVEL__ < 40801
+#define POLY_NO_REF_QUALIFIERS
+#endif
+#elif defined(_MSC_VER)
+#if _MSC_VER < 1900
+#define POLY_NO_REF_QUALIFIERS
+#endif
+#endif
+#endif
+
+// Building with `-fno-exceptions`, or `-fno-rtti`. Define the macros to get the
+// same behaviour anyway.
+#ifndef POLY_NO_EXCEPTIONS
+#if !defined(__cpp_exceptions) && !defined(__EXCEPTIONS) && \
+    !defined(_CPPUNWIND)
+#define POLY_NO_EXCEPTIONS
+#endif
+#endif
+
+#ifndef POLY_NO_RTTI
+#if !defined(__cpp_rtti) && !defined(__GXX_RTTI) && !defined(_CPPRTTI)
+#define POLY_NO_RTTI
+#endif
+#endif
+
+// Cleaning up after an exception, where there can be none without them.
+#ifndef POLY_NO_EXCEPTIONS
+#define POLY_DETAIL_TRY try
+#define POLY_DETAIL_CATCH_ALL catch (...)
+#define POLY_DETAIL_RETHROW throw
+#else
+#define POLY_DETAIL_TRY if (true)
+#define POLY_DETAIL_CATCH_ALL else
+#define POLY_DETAIL_RETHROW ((void)0)
+#endif
+
+// Failure paths, kept out of line and away from the code around them.
+#if defined(__GNUC__)
+#define POLY_DETAIL_COLD __attribute__((cold, noinline))
+#elif defined(_MSC_VER)
+#define POLY_DETAIL_COLD __declspec(noinline)
+#else
+#define POLY_DETAIL_COLD
+#endif
 
 #endif // POLY_DETAIL_CONFIG_HPP_0GP7OI1
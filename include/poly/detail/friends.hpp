@@ -8,6 +8,7 @@
 
 #include <poly/detail/forward_like.hpp>
 #include <poly/detail/signature.hpp>
+#include <utility>
 
 namespace poly {
 namespace detail {
@@ -17,24 +18,61 @@ template <typename Interface, typename... Signatures> struct friends;
 template <typename Interface> struct friends<Interface> {};
 
 template <typename I,
-          typename R, typename F, typename... Args, typename Self,
-          typename... Signatures>
-struct friends<I, signature<R(F, Args...), Self>, Signatures...>
+          typename R, typename F, typename... Args POLY_DETAIL_NX_PARAM,
+          typename Self, typename... Signatures>
+struct friends<I, signature<R(F, Args...) POLY_DETAIL_NX, Self>, Signatures...>
     : friends<I, Signatures...>
 {
-    friend R call(F f, typename self_to_this_<Args, I>::type... args) {
+    friend R call(F f, typename self_to_this_<Args, I>::type... args)
+    POLY_DETAIL_NX
+    {
         return forward_like<Self>(self_from<Args...>::apply(
             std::forward<typename self_to_this_<Args, I>::type>(args)...).get())
             (f, forward_self<Args>()(args)...);
     }
 };
 
-template <typename I, typename F, typename... Args, typename Self,
+// Consuming `self` to return the interface type: the result may have adopted
+// the model of `self` (see implement.hpp).
+
+template <typename I, typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct friends<I, signature<void(F, Args...), Self>, Signatures...>
+struct friends<I, signature<I(F, Args...) POLY_DETAIL_NX, self>, Signatures...>
+    : friends<I, Signatures...>
+{
+    friend I call(F f, typename self_to_this_<Args, I>::type... args)
+    POLY_DETAIL_NX
+    {
+        return consume(self_from<Args...>::apply(
+            std::forward<typename self_to_this_<Args, I>::type>(args)...),
+            f, forward_self<Args>()(args)...);
+    }
+
+    template <typename... A>
+    static I consume(I && s, A &&... a) POLY_DETAIL_NX {
+        I r = std::move(s.get())(std::forward<A>(a)...);
+        static_cast<typename I::base &>(s).disown(r);
+        return r;
+    }
+};
+
+// Same for `self &&`; the base only differs from this in its tag argument.
+template <typename I, typename F, typename... Args POLY_DETAIL_NX_PARAM,
+          typename... Signatures>
+struct friends<I, signature<I(F, Args...) POLY_DETAIL_NX, self &&>,
+               Signatures...>
+    : friends<I, signature<I(F, Args...) POLY_DETAIL_NX, self>, Signatures...>
+{};
+
+template <typename I, typename F, typename... Args POLY_DETAIL_NX_PARAM,
+          typename Self, typename... Signatures>
+struct friends<I, signature<void(F, Args...) POLY_DETAIL_NX, Self>,
+               Signatures...>
     : friends<I, Signatures...>
 {
-    friend void call(F f, typename self_to_this_<Args, I>::type... args) {
+    friend void call(F f, typename self_to_this_<Args, I>::type... args)
+    POLY_DETAIL_NX
+    {
         forward_like<Self>(self_from<Args...>::apply(
             std::forward<typename self_to_this_<Args, I>::type>(args)...).get())
             (f, forward_self<Args>()(args)...);
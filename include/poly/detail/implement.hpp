@@ -7,10 +7,72 @@
 #define POLY_DETAIL_IMPLEMENT_HPP_ZF88244
 
 #include <poly/detail/signature.hpp>
+#include <poly/detail/signatures_of.hpp>
+#include <type_traits>
+#include <utility>
 
 namespace poly {
 namespace detail {
 
+// --- reuse_self<R>(model, result) --------------------------------------------
+
+// A signature which consumes `poly::self` and returns the interface type can
+// move a result of the held type back into the consumed model, and return an
+// interface adopting that model instead of allocating a new one. The caller
+// (see friends.hpp) then gives up its ownership of the model.
+
+template <typename R, typename M, typename U, typename Enable=void>
+struct can_reuse_self : std::false_type {};
+
+template <typename R, typename M, typename U>
+struct can_reuse_self<R, M, U,
+    typename std::enable_if<is_interface<R>::value>::type>
+{
+    typedef decltype(std::declval<M &>().x) T;
+    static constexpr bool value =
+        std::is_same<typename R::template model<T>, M>::value &&
+        std::is_same<typename std::decay<U>::type, T>::value &&
+        std::is_move_assignable<T>::value;
+};
+
+template <typename R, typename M, typename U>
+R reuse_self(M &, U && u, std::false_type) {
+    return std::forward<U>(u);
+}
+
+template <typename R, typename M, typename U>
+R reuse_self(M & m, U && u, std::true_type) {
+    m.x = std::forward<U>(u);
+    return M::adopt(&m);
+}
+
+template <typename R, typename M, typename U>
+R reuse_self(M & m, U && u) {
+    return reuse_self<R>(m, std::forward<U>(u), std::integral_constant<bool,
+        can_reuse_self<R, M, U>::value>());
+}
+
+// --- nothrow_call<NX, M, F, Args...> -----------------------------------------
+
+// Whether the `call` a model `M` makes for the signature `R(F, Args...)` is
+// known not to throw, as required of `noexcept` signatures.
+
+template <bool NX, typename M, typename F, typename... Args>
+struct nothrow_call : std::true_type {};
+
+template <typename M, typename F, typename... Args>
+struct nothrow_call<true, M, F, Args...> {
+    typedef decltype(std::declval<M &>().x) T;
+    static constexpr bool value = noexcept(call(std::declval<F &>(),
+        std::declval<typename self_to_this_<Args, T>::type>()...));
+};
+
+#define POLY_DETAIL_ASSERT_NOTHROW(M)                            \
+    static_assert(nothrow_call<POLY_DETAIL_NX_VALUE, M, F,       \
+                               Args...>::value,                  \
+        "call() implementing a noexcept signature may throw")    \
+    /**/
+
 // --- implement<Model, Concept, Signatures...> --------------------------------
 
 template <typename Model, typename Concept, typename... Signatures>
@@ -22,50 +84,64 @@ struct implement<Model, Concept> : Concept {};
 // non-void rvalue
 
 template <typename M, typename C,
-          typename R, typename F, typename... Args,
+          typename R, typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct implement<M, C, signature<R(F, Args...), self>, Signatures...>
+struct implement<M, C, signature<R(F, Args...) POLY_DETAIL_NX, self>,
+                 Signatures...>
     : implement<M, C, Signatures...>
 {
-    virtual R operator()(F f, Args... args) POLY_DETAIL_RREF override {
-        return call(f, self_to_this(std::forward<Args>(args),
-                                    static_cast<M &&>(*this).x)...);
+    virtual R operator()(F f, Args... args) POLY_DETAIL_RREF POLY_DETAIL_NX
+    override {
+        POLY_DETAIL_ASSERT_NOTHROW(M);
+        return reuse_self<R>(static_cast<M &>(*this),
+            call(f, self_to_this(std::forward<Args>(args),
+                                 static_cast<M &&>(*this).x)...));
     }
 };
 
 template <typename M, typename C,
-          typename R, typename F, typename... Args,
+          typename R, typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct implement<M, C, signature<R(F, Args...), self &&>, Signatures...>
+struct implement<M, C, signature<R(F, Args...) POLY_DETAIL_NX, self &&>,
+                 Signatures...>
     : implement<M, C, Signatures...>
 {
-    virtual R operator()(F f, Args... args) POLY_DETAIL_RREF override {
-        return call(f, self_to_this(std::forward<Args>(args),
-                                    static_cast<M &&>(*this).x)...);
+    virtual R operator()(F f, Args... args) POLY_DETAIL_RREF POLY_DETAIL_NX
+    override {
+        POLY_DETAIL_ASSERT_NOTHROW(M);
+        return reuse_self<R>(static_cast<M &>(*this),
+            call(f, self_to_this(std::forward<Args>(args),
+                                 static_cast<M &&>(*this).x)...));
     }
 };
 
 // non-void lvalue
 
 template <typename M, typename C,
-          typename R, typename F, typename... Args,
+          typename R, typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct implement<M, C, signature<R(F, Args...), self &>, Signatures...>
+struct implement<M, C, signature<R(F, Args...) POLY_DETAIL_NX, self &>,
+                 Signatures...>
     : implement<M, C, Signatures...>
 {
-    virtual R operator()(F f, Args... args) POLY_DETAIL_LREF override {
+    virtual R operator()(F f, Args... args) POLY_DETAIL_LREF POLY_DETAIL_NX
+    override {
+        POLY_DETAIL_ASSERT_NOTHROW(M);
         return call(f, self_to_this(std::forward<Args>(args),
                                     static_cast<M &>(*this).x)...);
     }
 };
 
 template <typename M, typename C,
-          typename R, typename F, typename... Args,
+          typename R, typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct implement<M, C, signature<R(F, Args...), self const &>, Signatures...>
+struct implement<M, C, signature<R(F, Args...) POLY_DETAIL_NX, self const &>,
+                 Signatures...>
     : implement<M, C, Signatures...>
 {
-    virtual R operator()(F f, Args... args) const POLY_DETAIL_LREF override {
+    virtual R operator()(F f, Args... args) const POLY_DETAIL_LREF
+    POLY_DETAIL_NX override {
+        POLY_DETAIL_ASSERT_NOTHROW(M);
         return call(f, self_to_this(std::forward<Args>(args),
                                     static_cast<M const &>(*this).x)...);
     }
@@ -74,24 +150,30 @@ struct implement<M, C, signature<R(F, Args...), self const &>, Signatures...>
 // void rvalue
 
 template <typename M, typename C,
-          typename F, typename... Args,
+          typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct implement<M, C, signature<void(F, Args...), self>, Signatures...>
+struct implement<M, C, signature<void(F, Args...) POLY_DETAIL_NX, self>,
+                 Signatures...>
     : implement<M, C, Signatures...>
 {
-    virtual void operator()(F f, Args... args) POLY_DETAIL_RREF override {
+    virtual void operator()(F f, Args... args) POLY_DETAIL_RREF POLY_DETAIL_NX
+    override {
+        POLY_DETAIL_ASSERT_NOTHROW(M);
         call(f, self_to_this(std::forward<Args>(args),
                              static_cast<M &&>(*this).x)...);
     }
 };
 
 template <typename M, typename C,
-          typename F, typename... Args,
+          typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct implement<M, C, signature<void(F, Args...), self &&>, Signatures...>
+struct implement<M, C, signature<void(F, Args...) POLY_DETAIL_NX, self &&>,
+                 Signatures...>
     : implement<M, C, Signatures...>
 {
-    virtual void operator()(F f, Args... args) POLY_DETAIL_RREF override {
+    virtual void operator()(F f, Args... args) POLY_DETAIL_RREF POLY_DETAIL_NX
+    override {
+        POLY_DETAIL_ASSERT_NOTHROW(M);
         call(f, self_to_this(std::forward<Args>(args),
                              static_cast<M &&>(*this).x)...);
     }
@@ -100,29 +182,37 @@ struct implement<M, C, signature<void(F, Args...), self &&>, Signatures...>
 // void lvalue
 
 template <typename M, typename C,
-          typename F, typename... Args,
+          typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct implement<M, C, signature<void(F, Args...), self &>, Signatures...>
+struct implement<M, C, signature<void(F, Args...) POLY_DETAIL_NX, self &>,
+                 Signatures...>
     : implement<M, C, Signatures...>
 {
-    virtual void operator()(F f, Args... args) POLY_DETAIL_LREF override {
+    virtual void operator()(F f, Args... args) POLY_DETAIL_LREF POLY_DETAIL_NX
+    override {
+        POLY_DETAIL_ASSERT_NOTHROW(M);
         call(f, self_to_this(std::forward<Args>(args),
                              static_cast<M &>(*this).x)...);
     }
 };
 
 template <typename M, typename C,
-          typename F, typename... Args,
+          typename F, typename... Args POLY_DETAIL_NX_PARAM,
           typename... Signatures>
-struct implement<M, C, signature<void(F, Args...), self const &>, Signatures...>
+struct implement<M, C, signature<void(F, Args...) POLY_DETAIL_NX, self const &>,
+                 Signatures...>
     : implement<M, C, Signatures...>
 {
-    virtual void operator()(F f, Args... args) const POLY_DETAIL_LREF override {
+    virtual void operator()(F f, Args... args) const POLY_DETAIL_LREF
+    POLY_DETAIL_NX override {
+        POLY_DETAIL_ASSERT_NOTHROW(M);
         call(f, self_to_this(std::forward<Args>(args),
                              static_cast<M const &>(*this).x)...);
     }
 };
 
+#undef POLY_DETAIL_ASSERT_NOTHROW
+
 } // detail
 } // poly
 
@@ -0,0 +1,27 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_DETAIL_INDICES_HPP_5KD0RWE
+#define POLY_DETAIL_INDICES_HPP_5KD0RWE
+
+#include <cstddef>
+
+namespace poly {
+namespace detail {
+
+// --- indices<I...>, make_indices<N>::type ------------------------------------
+
+template <std::size_t... I> struct indices {};
+
+template <std::size_t N, std::size_t... I>
+struct make_indices : make_indices<N - 1, N - 1, I...> {};
+
+template <std::size_t... I>
+struct make_indices<0, I...> { typedef indices<I...> type; };
+
+} // detail
+} // poly
+
+#endif // POLY_DETAIL_INDICES_HPP_5KD0RWE
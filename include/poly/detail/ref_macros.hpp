@@ -16,4 +16,17 @@
 #define POLY_DETAIL_RREF
 #endif
 
+// Where `noexcept` is part of the function type (C++17), the specializations
+// matching a signature `R(F, Args...) noexcept(NX)` deduce `NX` and declare the
+// dispatching functions `noexcept(NX)`. Otherwise `NX` is always `false`.
+#ifdef __cpp_noexcept_function_type
+#define POLY_DETAIL_NX_PARAM , bool NX
+#define POLY_DETAIL_NX noexcept(NX)
+#define POLY_DETAIL_NX_VALUE NX
+#else
+#define POLY_DETAIL_NX_PARAM
+#define POLY_DETAIL_NX
+#define POLY_DETAIL_NX_VALUE false
+#endif
+
 #endif // POLY_DETAIL_REF_MACROS_HPP_C045URO
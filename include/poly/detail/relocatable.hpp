@@ -0,0 +1,57 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_DETAIL_RELOCATABLE_HPP_H3VY9PC
+#define POLY_DETAIL_RELOCATABLE_HPP_H3VY9PC
+
+#include <poly/detail/signatures_of.hpp>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace poly {
+
+namespace detail {
+
+// An interface which adds no data members to its `base`, and so only holds
+// the pointer to its heap-allocated model.
+template <typename T, typename Enable=void>
+struct is_bare_interface : std::false_type {};
+
+template <typename T>
+struct is_bare_interface<T,
+    typename std::enable_if<is_interface<T>::value>::type>
+    : std::integral_constant<bool,
+          sizeof(T) == sizeof(typename T::base) &&
+          std::is_standard_layout<T>::value> {};
+
+} // detail
+
+// --- is_trivially_relocatable<T> ---------------------------------------------
+
+template <typename T, typename Enable=void>
+struct is_trivially_relocatable
+    : std::integral_constant<bool, std::is_trivially_copyable<T>::value> {};
+
+template <typename T>
+struct is_trivially_relocatable<T,
+    typename std::enable_if<detail::is_bare_interface<T>::value>::type>
+    : std::true_type {};
+
+} // poly
+
+#if defined(__GLIBCXX__) && defined(_GLIBCXX_RELEASE) && _GLIBCXX_RELEASE >= 9
+
+// Let libstdc++ reallocate `std::vector<Interface>` by `memmove`.
+namespace std {
+template <typename T>
+struct __is_bitwise_relocatable<T,
+    typename enable_if<::poly::detail::is_bare_interface<T>::value>::type>
+    : true_type {};
+} // std
+
+#endif
+
+#endif // POLY_DETAIL_RELOCATABLE_HPP_H3VY9PC
@@ -6,6 +6,7 @@
 #ifndef POLY_DETAIL_SELF_HPP_1PQ4JF0
 #define POLY_DETAIL_SELF_HPP_1PQ4JF0
 
+#include <poly/detail/ref_macros.hpp>
 #include <poly/detail/strip.hpp>
 
 namespace poly {
@@ -104,8 +105,9 @@ template <> struct self_from<> {
 // --- self_from_signature<R(F, Args0..., self [[const] &], Args1...)> ---------
 
 template <typename Sig> struct self_from_signature { typedef void type; };
-template <typename R, typename F, typename... Args>
-struct self_from_signature<R(F, Args...)> : self_from<Args...> {};
+template <typename R, typename F, typename... Args POLY_DETAIL_NX_PARAM>
+struct self_from_signature<R(F, Args...) POLY_DETAIL_NX>
+    : self_from<Args...> {};
 
 } // detail
 } // poly
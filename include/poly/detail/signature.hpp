@@ -15,24 +15,24 @@ namespace detail {
 template <typename Sig, typename Self=typename self_from_signature<Sig>::type>
 struct signature;
 
-template <typename R, typename F, typename... A>
-struct signature<R(F, A...), self> {
-    virtual R operator()(F, A...) POLY_DETAIL_RREF = 0;
+template <typename R, typename F, typename... A POLY_DETAIL_NX_PARAM>
+struct signature<R(F, A...) POLY_DETAIL_NX, self> {
+    virtual R operator()(F, A...) POLY_DETAIL_RREF POLY_DETAIL_NX = 0;
 };
 
-template <typename R, typename F, typename... A>
-struct signature<R(F, A...), self &&> {
-    virtual R operator()(F, A...) POLY_DETAIL_RREF = 0;
+template <typename R, typename F, typename... A POLY_DETAIL_NX_PARAM>
+struct signature<R(F, A...) POLY_DETAIL_NX, self &&> {
+    virtual R operator()(F, A...) POLY_DETAIL_RREF POLY_DETAIL_NX = 0;
 };
 
-template <typename R, typename F, typename... A>
-struct signature<R(F, A...), self &> {
-    virtual R operator()(F, A...) POLY_DETAIL_LREF = 0;
+template <typename R, typename F, typename... A POLY_DETAIL_NX_PARAM>
+struct signature<R(F, A...) POLY_DETAIL_NX, self &> {
+    virtual R operator()(F, A...) POLY_DETAIL_LREF POLY_DETAIL_NX = 0;
 };
 
-template <typename R, typename F, typename... A>
-struct signature<R(F, A...), self const &> {
-    virtual R operator()(F, A...) const POLY_DETAIL_LREF = 0;
+template <typename R, typename F, typename... A POLY_DETAIL_NX_PARAM>
+struct signature<R(F, A...) POLY_DETAIL_NX, self const &> {
+    virtual R operator()(F, A...) const POLY_DETAIL_LREF POLY_DETAIL_NX = 0;
 };
 
 } // detail
@@ -20,30 +20,40 @@ struct signatures {
     void operator()() const noexcept {}
 };
 
-template <typename R, typename F, typename... A, typename... Sig>
-struct signatures<seq<R(F, A...), Sig...>, self> : signatures<seq<Sig...>> {
+template <typename R, typename F, typename... A POLY_DETAIL_NX_PARAM,
+          typename... Sig>
+struct signatures<seq<R(F, A...) POLY_DETAIL_NX, Sig...>, self>
+    : signatures<seq<Sig...>>
+{
     using signatures<seq<Sig...>>::operator();
-    virtual R operator()(F, A...) POLY_DETAIL_RREF = 0;
+    virtual R operator()(F, A...) POLY_DETAIL_RREF POLY_DETAIL_NX = 0;
 };
 
-template <typename R, typename F, typename... A, typename... Sig>
-struct signatures<seq<R(F, A...), Sig...>, self &&> : signatures<seq<Sig...>> {
+template <typename R, typename F, typename... A POLY_DETAIL_NX_PARAM,
+          typename... Sig>
+struct signatures<seq<R(F, A...) POLY_DETAIL_NX, Sig...>, self &&>
+    : signatures<seq<Sig...>>
+{
     using signatures<seq<Sig...>>::operator();
-    virtual R operator()(F, A...) POLY_DETAIL_RREF = 0;
+    virtual R operator()(F, A...) POLY_DETAIL_RREF POLY_DETAIL_NX = 0;
 };
 
-template <typename R, typename F, typename... A, typename... Sig>
-struct signatures<seq<R(F, A...), Sig...>, self &> : signatures<seq<Sig...>> {
+template <typename R, typename F, typename... A POLY_DETAIL_NX_PARAM,
+          typename... Sig>
+struct signatures<seq<R(F, A...) POLY_DETAIL_NX, Sig...>, self &>
+    : signatures<seq<Sig...>>
+{
     using signatures<seq<Sig...>>::operator();
-    virtual R operator()(F, A...) POLY_DETAIL_LREF = 0;
+    virtual R operator()(F, A...) POLY_DETAIL_LREF POLY_DETAIL_NX = 0;
 };
 
-template <typename R, typename F, typename... A, typename... Sig>
-struct signatures<seq<R(F, A...), Sig...>, self const &>
+template <typename R, typename F, typename... A POLY_DETAIL_NX_PARAM,
+          typename... Sig>
+struct signatures<seq<R(F, A...) POLY_DETAIL_NX, Sig...>, self const &>
     : signatures<seq<Sig...>>
 {
     using signatures<seq<Sig...>>::operator();
-    virtual R operator()(F, A...) const POLY_DETAIL_LREF = 0;
+    virtual R operator()(F, A...) const POLY_DETAIL_LREF POLY_DETAIL_NX = 0;
 };
 
 } // detail
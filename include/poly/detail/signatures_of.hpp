@@ -0,0 +1,61 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_DETAIL_SIGNATURES_OF_HPP_W0L3ZQ8
+#define POLY_DETAIL_SIGNATURES_OF_HPP_W0L3ZQ8
+
+#include <poly/detail/seq.hpp>
+#include <type_traits>
+#include <utility>
+
+namespace poly {
+
+template <typename... Signatures> struct interface;
+
+namespace detail {
+
+// --- signatures_of<Interface>::type ------------------------------------------
+
+// The signature list `seq<Signatures...>` of an interface, whether it was
+// defined as `interface<Signatures...>` or through CRTP.
+
+template <typename Base> struct signatures_of_base;
+template <typename I, typename... Signatures>
+struct signatures_of_base<interface<I, Signatures...>> {
+    typedef seq<Signatures...> type;
+};
+
+template <typename Interface>
+struct signatures_of : signatures_of_base<typename Interface::base> {};
+
+// --- is_interface<T> ---------------------------------------------------------
+
+template <typename T> struct is_interface_base : std::false_type {};
+template <typename I, typename... Signatures>
+struct is_interface_base<interface<I, Signatures...>> : std::true_type {};
+
+template <typename T> struct void_ { typedef void type; };
+
+template <typename T, typename Enable=void>
+struct is_interface : std::false_type {};
+template <typename T>
+struct is_interface<T, typename void_<typename T::base>::type>
+    : is_interface_base<typename T::base> {};
+
+// --- converts_to<T, Interface> -----------------------------------------------
+
+// True if `T` has a conversion function to `Interface`, as a static model of
+// it does.
+template <typename T, typename Interface, typename Enable=void>
+struct converts_to : std::false_type {};
+template <typename T, typename Interface>
+struct converts_to<T, Interface, typename void_<
+    decltype(std::declval<T const &>().operator Interface())>::type>
+    : std::true_type {};
+
+} // detail
+} // poly
+
+#endif // POLY_DETAIL_SIGNATURES_OF_HPP_W0L3ZQ8
@@ -0,0 +1,215 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_DETAIL_STORAGE_HPP_8WN3KQD
+#define POLY_DETAIL_STORAGE_HPP_8WN3KQD
+
+#include <poly/detail/type_tag.hpp>
+#include <poly/failure.hpp>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace poly {
+namespace detail {
+
+// --- fits_inline<T, Size, Align> ---------------------------------------------
+
+// Models of `T` are stored inline if `T` fits in `Size` bytes aligned to
+// `Align` (the buffer has room for the vtable pointer of the model besides)
+// and can be moved without throwing. Otherwise, they go to the heap.
+
+template <typename T, std::size_t Size, std::size_t Align>
+struct fits_inline : std::integral_constant<bool,
+    sizeof(T) <= Size && Align % alignof(T) == 0 &&
+    std::is_nothrow_move_constructible<T>::value> {};
+
+// --- storable<Base, Copyable> ------------------------------------------------
+
+template <typename Base, bool Copyable> struct storable;
+
+template <typename Base> struct storable<Base, false> : Base {
+    virtual ~storable() = default;
+    virtual storable * relocate(void * buffer) noexcept = 0;
+    virtual void * data() noexcept = 0;
+    virtual type_id const * tag() const noexcept = 0;
+
+    void const * data() const noexcept {
+        return const_cast<storable *>(this)->data();
+    }
+};
+
+template <typename Base> struct storable<Base, true> : Base {
+    virtual ~storable() = default;
+    virtual storable * relocate(void * buffer) noexcept = 0;
+    virtual storable * clone(void * buffer) const = 0;
+    virtual void * data() noexcept = 0;
+    virtual type_id const * tag() const noexcept = 0;
+
+    void const * data() const noexcept {
+        return const_cast<storable *>(this)->data();
+    }
+};
+
+// --- stored<Model, Concept, T, Size, Align, Copyable> ------------------------
+
+template <typename M, typename C, typename T,
+          std::size_t Size, std::size_t Align, bool Copyable>
+struct stored;
+
+template <typename M, typename C, typename T,
+          std::size_t Size, std::size_t Align>
+struct stored<M, C, T, Size, Align, false> : C {
+    typedef fits_inline<T, Size, Align> local;
+
+    virtual C * relocate(void * buffer) noexcept override {
+        assert(local::value);
+        M & m = static_cast<M &>(*this);
+        C * r = ::new (buffer) M(std::move(m.x));
+        m.~M();
+        return r;
+    }
+    virtual void * data() noexcept override {
+        return &static_cast<M &>(*this).x;
+    }
+    virtual type_id const * tag() const noexcept override {
+        return &type_tag<T>::id;
+    }
+    static void * operator new(std::size_t n) { return allocate(n); }
+    static void operator delete(void * p) noexcept { ::operator delete(p); }
+#ifdef __cpp_aligned_new
+    static void * operator new(std::size_t n, std::align_val_t a) {
+        return ::operator new(n, a);
+    }
+    static void operator delete(void * p, std::align_val_t a) noexcept {
+        ::operator delete(p, a);
+    }
+#endif
+};
+
+template <typename M, typename C, typename T,
+          std::size_t Size, std::size_t Align>
+struct stored<M, C, T, Size, Align, true>
+    : stored<M, C, T, Size, Align, false>
+{
+    virtual C * clone(void * buffer) const override {
+        M const & m = static_cast<M const &>(*this);
+        if (fits_inline<T, Size, Align>::value) return ::new (buffer) M(m.x);
+        return new M(m.x);
+    }
+};
+
+// --- storage<Concept, Size, Align> -------------------------------------------
+
+// Owning handle to a model which lives either in the inline buffer or on the
+// heap. Moves never throw: local models are relocated through the virtual
+// `relocate` hook, remote ones by stealing the pointer.
+
+template <typename Concept, std::size_t Size, std::size_t Align>
+class storage {
+    static_assert(Size >= sizeof(void *), "buffer too small");
+    static_assert(Align >= alignof(void *), "buffer underaligned");
+
+    // The vtable pointer, padded to `Align`, followed by the value.
+    static constexpr std::size_t buffer_size =
+        (sizeof(void *) + Align - 1) / Align * Align + Size;
+
+public:
+    static constexpr std::size_t size = Size;
+    static constexpr std::size_t align = Align;
+
+    storage() noexcept : remote(nullptr), local(false) {}
+
+    storage(storage && x) noexcept : remote(nullptr), local(false) {
+        steal(x);
+    }
+
+    storage(storage const & x) : remote(nullptr), local(false) {
+        if (x.valid()) set(x.get()->clone(&buffer));
+    }
+
+    storage & operator=(storage && x) noexcept {
+        if (this != &x) {
+            reset();
+            steal(x);
+        }
+        return *this;
+    }
+
+    storage & operator=(storage const & x) {
+        return *this = storage(x);
+    }
+
+    ~storage() { reset(); }
+
+    template <typename M, typename... Args>
+    void emplace(Args &&... args) {
+        reset();
+        static_assert(!M::local::value || sizeof(M) <= buffer_size,
+                      "model does not fit in the buffer");
+        if (M::local::value) {
+            Concept * p = ::new (&buffer) M(std::forward<Args>(args)...);
+            assert(static_cast<void *>(p) == static_cast<void *>(&buffer));
+            (void)p;
+            local = true;
+        } else {
+            remote = new M(std::forward<Args>(args)...);
+        }
+    }
+
+    void reset() noexcept {
+        if (local) get()->~Concept();
+        else delete remote;
+        remote = nullptr;
+        local = false;
+    }
+
+    bool valid() const noexcept { return local || remote; }
+    bool is_local() const noexcept { return local; }
+
+    Concept * get() noexcept {
+        return local ? static_cast<Concept *>(static_cast<void *>(&buffer))
+                     : remote;
+    }
+    Concept const * get() const noexcept {
+        return local
+            ? static_cast<Concept const *>(static_cast<void const *>(&buffer))
+            : remote;
+    }
+
+private:
+    void set(Concept * p) noexcept {
+        if (static_cast<void *>(p) == static_cast<void *>(&buffer)) {
+            local = true;
+        } else {
+            remote = p;
+        }
+    }
+
+    void steal(storage & x) noexcept {
+        if (x.local) {
+            x.get()->relocate(&buffer);
+            local = true;
+            x.local = false;
+            x.remote = nullptr;
+        } else {
+            remote = x.remote;
+            x.remote = nullptr;
+        }
+    }
+
+    union {
+        Concept * remote;
+        typename std::aligned_storage<buffer_size, Align>::type buffer;
+    };
+    bool local;
+};
+
+} // detail
+} // poly
+
+#endif // POLY_DETAIL_STORAGE_HPP_8WN3KQD
@@ -0,0 +1,41 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_DETAIL_TYPE_TAG_HPP_P3XM8RC
+#define POLY_DETAIL_TYPE_TAG_HPP_P3XM8RC
+
+#include <poly/detail/config.hpp>
+#include <typeinfo>
+
+namespace poly {
+namespace detail {
+
+// --- type_tag<T>::id ---------------------------------------------------------
+
+// A unique address for each type, to compare types in O(1), also without
+// RTTI. With RTTI, it knows the `std::type_info` of the type too.
+
+struct type_id {
+#ifndef POLY_NO_RTTI
+    std::type_info const * info;
+#endif
+};
+
+#ifndef POLY_NO_RTTI
+template <typename T> struct type_tag {
+    static constexpr type_id id{&typeid(T)};
+};
+#else
+template <typename T> struct type_tag {
+    static constexpr type_id id{};
+};
+#endif
+
+template <typename T> constexpr type_id type_tag<T>::id;
+
+} // detail
+} // poly
+
+#endif // POLY_DETAIL_TYPE_TAG_HPP_P3XM8RC
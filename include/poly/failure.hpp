@@ -0,0 +1,94 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_FAILURE_HPP_Q7NB2VU
+#define POLY_FAILURE_HPP_Q7NB2VU
+
+/// Header <poly/failure.hpp>
+/// =========================
+///
+/// What happens when an operation fails in a build without exceptions.
+///
+///
+/// Builds without exceptions
+/// -------------------------
+///
+/// When compiled without exceptions (`-fno-exceptions`, or with
+/// `POLY_NO_EXCEPTIONS` defined), the library never throws. Where it would
+/// throw, e.g. `poly::bad_cast` from `get<T>()` on a value of another type, or
+/// `std::bad_alloc` when out of memory, it calls the failure handler instead,
+/// with the `what()` string of the exception, and then `std::abort()`s.
+///
+/// Every such operation has a non-failing alternative for checking first:
+/// `target<T>()` and `poly::cast<T>(&x)` return null for a value of another
+/// type, and so on.
+///
+/// Without RTTI (`-fno-rtti`, or `POLY_NO_RTTI`), the `type()` members are
+/// left out; type checks never needed them.
+///
+///
+/// Functions `poly::set_failure_handler(h)`, `poly::get_failure_handler()`
+/// -----------------------------------------------------------------------
+///
+/// Install the handler `h`, of type `void (*)(char const * what)`, returning
+/// the previous one. The handler should not return, e.g. log `what` and
+/// exit; if it does, `std::abort()` is called. The default handler, null,
+/// does nothing. With exceptions, the handler is never called.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/detail/config.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+namespace poly {
+
+typedef void (*failure_handler)(char const * what);
+
+namespace detail {
+
+inline std::atomic<failure_handler> & current_failure_handler() noexcept {
+    static std::atomic<failure_handler> h(nullptr);
+    return h;
+}
+
+// Throw `e`, or call the failure handler without exceptions.
+template <typename E>
+[[noreturn]] POLY_DETAIL_COLD void raise(E const & e) {
+#ifndef POLY_NO_EXCEPTIONS
+    throw e;
+#else
+    if (failure_handler h = current_failure_handler().load()) h(e.what());
+    std::abort();
+#endif
+}
+
+// `::operator new(n)`, calling the failure handler when out of memory in
+// builds without exceptions.
+inline void * allocate(std::size_t n) {
+#ifndef POLY_NO_EXCEPTIONS
+    return ::operator new(n);
+#else
+    void * p = ::operator new(n, std::nothrow);
+    if (!p) raise(std::bad_alloc());
+    return p;
+#endif
+}
+
+} // detail
+
+inline failure_handler set_failure_handler(failure_handler h) noexcept {
+    return detail::current_failure_handler().exchange(h);
+}
+
+inline failure_handler get_failure_handler() noexcept {
+    return detail::current_failure_handler().load();
+}
+
+} // poly
+
+#endif // POLY_FAILURE_HPP_Q7NB2VU
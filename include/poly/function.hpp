@@ -0,0 +1,253 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_FUNCTION_HPP_M2Q8VZE
+#define POLY_FUNCTION_HPP_M2Q8VZE
+
+/// Header <poly/function.hpp>
+/// ==========================
+///
+/// Type-erased function objects with several overloaded call signatures.
+///
+///
+/// Class template `poly::function<Signatures...>`
+/// ----------------------------------------------
+///
+/// A copyable wrapper for any copyable function object which can be called
+/// with each of the `Signatures...`, given as plain function types `R(A...)`.
+/// The call operator picks the overload by the usual overload resolution:
+///
+///     poly::function<std::string(int), std::string(std::string)> f =
+///         [](auto x) { return to_string(x); };
+///     f(1);                   // calls the int overload
+///     f(std::string("abc"));  // calls the std::string overload
+///
+/// Internally, `R(A...)` is treated as the interface signature
+/// `R(invoke_, poly::self &, A...)`, so the same machinery as with
+/// `poly::interface` is used for dispatching.
+///
+/// Function objects whose size is at most `buffer_size` bytes (by default
+/// `POLY_FUNCTION_BUFFER_SIZE`, i.e. three pointers), whose alignment divides
+/// `buffer_align`, and which have a non-throwing move constructor, are
+/// guaranteed to be stored inline without allocation. Moves of
+/// `poly::function` never throw.
+///
+/// Like with `std::function`, the call operator is `const` but invokes the
+/// target as a non-const lvalue, and only function objects callable that way
+/// with each of the `Signatures...` convert to `poly::function`.
+///
+///
+/// Class template `poly::unique_function<Signatures...>`
+/// -----------------------------------------------------
+///
+/// Like `poly::function<Signatures...>`, but move-only; accepts move-only
+/// function objects too.
+///
+///
+/// Macro `POLY_FUNCTION_BUFFER_SIZE`
+/// ---------------------------------
+///
+/// The inline buffer size of `poly::function` and `poly::unique_function`.
+/// Define before including this header to override. Must be at least
+/// `sizeof(void *)`.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/callable.hpp>
+#include <poly/detail/friends.hpp>
+#include <poly/detail/implement.hpp>
+#include <poly/detail/is_plain.hpp>
+#include <poly/detail/signatures.hpp>
+#include <poly/detail/storage.hpp>
+#include <cstddef>
+#include <type_traits>
+
+#ifndef POLY_FUNCTION_BUFFER_SIZE
+#define POLY_FUNCTION_BUFFER_SIZE (3 * sizeof(void *))
+#endif
+
+namespace poly {
+
+template <bool Copyable, typename... Signatures> class basic_function;
+
+namespace detail {
+
+POLY_CALLABLE(invoke);
+
+template <bool Copyable> struct copy_policy {};
+template <> struct copy_policy<false> {
+    copy_policy() = default;
+    copy_policy(copy_policy &&) = default;
+    copy_policy(copy_policy const &) = delete;
+    copy_policy & operator=(copy_policy &&) = default;
+    copy_policy & operator=(copy_policy const &) = delete;
+};
+
+template <typename T> struct is_function_ : std::false_type {};
+template <bool C, typename... Sigs>
+struct is_function_<basic_function<C, Sigs...>> : std::true_type {};
+
+template <typename F, typename... Args,
+          typename Enable=typename std::enable_if<
+              !is_function_<typename strip<F>::type>::value>::type>
+auto call(invoke_, F & f, Args &&... args)
+POLY_RETURNS_THROW(f(std::forward<Args>(args)...));
+
+// --- invoke_signature<R(A...)>::type -----------------------------------------
+
+template <typename Sig> struct invoke_signature;
+template <typename R, typename... A> struct invoke_signature<R(A...)> {
+    typedef R type(invoke_, self &, A...);
+};
+
+// --- callable_as<F, Sigs...> -------------------------------------------------
+
+// True if an lvalue of `F` can be called as each of `Sigs...`.
+template <typename F, typename... Sigs> struct callable_as : std::true_type {};
+
+template <typename F, typename Sig, typename Enable=void>
+struct callable_as_one : std::false_type {};
+
+template <typename F, typename R, typename... A>
+struct callable_as_one<F, R(A...),
+    decltype(void(std::declval<F &>()(std::declval<A>()...)))>
+    : std::integral_constant<bool, std::is_void<R>::value ||
+          std::is_convertible<
+              decltype(std::declval<F &>()(std::declval<A>()...)), R>::value>
+{};
+
+template <typename F, typename Sig, typename... Sigs>
+struct callable_as<F, Sig, Sigs...>
+    : std::integral_constant<bool, callable_as_one<F, Sig>::value &&
+                                   callable_as<F, Sigs...>::value> {};
+
+} // detail
+
+// -----------------------------------------------------------------------------
+
+template <bool Copyable, typename... Signatures>
+class basic_function
+    : public detail::friends<basic_function<Copyable, Signatures...>,
+          detail::signature<
+              typename detail::invoke_signature<Signatures>::type>...>
+    , detail::copy_policy<Copyable>
+{
+    typedef detail::signatures<detail::seq<
+        typename detail::invoke_signature<Signatures>::type...>> signatures;
+
+public:
+    static constexpr std::size_t buffer_size = POLY_FUNCTION_BUFFER_SIZE;
+    static constexpr std::size_t buffer_align = alignof(void *);
+
+    typedef detail::storable<signatures, Copyable> concept_type;
+
+    template <typename T>
+    struct model
+        : detail::implement<model<T>,
+              detail::stored<model<T>, concept_type, T,
+                             buffer_size, buffer_align, Copyable>,
+              detail::signature<
+                  typename detail::invoke_signature<Signatures>::type>...>
+    {
+        static_assert(detail::is_plain<T>::value, "unusable type!");
+        model(T && x) : x(std::move(x)) {}
+        model(T const & x) : x(x) {}
+        T x;
+    };
+
+    /// True if a function object of type `T` is stored without allocation.
+    template <typename T>
+    struct fits_inline
+        : detail::fits_inline<T, buffer_size, buffer_align> {};
+
+    basic_function() noexcept = default;
+    basic_function(std::nullptr_t) noexcept {}
+    basic_function(basic_function &&) noexcept = default;
+    basic_function(basic_function const &) = default;
+
+    template <typename T, typename Enable=typename std::enable_if<
+        !std::is_same<typename detail::strip<T>::type, basic_function>::value &&
+        detail::callable_as<typename std::decay<T>::type, Signatures...>::value
+        >::type>
+    basic_function(T && x) {
+        typedef typename std::decay<T>::type U;
+        static_assert(!Copyable || std::is_copy_constructible<U>::value,
+            "poly::function requires a copyable function object");
+        s.template emplace<model<U>>(std::forward<T>(x));
+    }
+
+    basic_function & operator=(basic_function &&) noexcept = default;
+    basic_function & operator=(basic_function const &) = default;
+    basic_function & operator=(std::nullptr_t) noexcept {
+        s.reset();
+        return *this;
+    }
+
+    void swap(basic_function & x) noexcept {
+        basic_function t(std::move(x));
+        x = std::move(*this);
+        *this = std::move(t);
+    }
+
+    explicit operator bool() const noexcept { return s.valid(); }
+    bool valid() const noexcept { return s.valid(); }
+
+    concept_type & get() POLY_DETAIL_LREF noexcept {
+        assert(valid());
+        return *s.get();
+    }
+    concept_type const & get() const POLY_DETAIL_LREF noexcept {
+        assert(valid());
+        return *s.get();
+    }
+
+#ifndef POLY_NO_RTTI
+    std::type_info const & type() const noexcept {
+        return valid() ? *s.get()->tag()->info : typeid(void);
+    }
+#endif
+
+    template <typename T> T * target() noexcept {
+        if (!holds<T>()) return nullptr;
+        return static_cast<T *>(s.get()->data());
+    }
+    template <typename T> T const * target() const noexcept {
+        if (!holds<T>()) return nullptr;
+        return static_cast<T const *>(s.get()->data());
+    }
+
+    template <typename... Args>
+    auto operator()(Args &&... args) const
+    -> decltype(call(detail::invoke, std::declval<basic_function &>(),
+                     std::forward<Args>(args)...))
+    {
+        return call(detail::invoke, const_cast<basic_function &>(*this),
+                    std::forward<Args>(args)...);
+    }
+
+private:
+    template <typename T> bool holds() const noexcept {
+        return valid() && s.get()->tag() == &detail::type_tag<T>::id;
+    }
+
+    detail::storage<concept_type, buffer_size, buffer_align> s;
+};
+
+template <bool C, typename... Sigs>
+inline void swap(basic_function<C, Sigs...> & a,
+                 basic_function<C, Sigs...> & b) noexcept
+{
+    a.swap(b);
+}
+
+template <typename... Signatures>
+using function = basic_function<true, Signatures...>;
+
+template <typename... Signatures>
+using unique_function = basic_function<false, Signatures...>;
+
+} // poly
+
+#endif // POLY_FUNCTION_HPP_M2Q8VZE
@@ -0,0 +1,150 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_HASH_HPP_J8C2NVW
+#define POLY_HASH_HPP_J8C2NVW
+
+/// Header <poly/hash.hpp>
+/// ======================
+///
+/// Hashing and equality for values held in interfaces.
+///
+///
+/// Callable `poly::hash(x)`
+/// ------------------------
+///
+/// Compute a `std::size_t` hash of `x`. The default implementation uses
+/// `std::hash<T>` for scalars and the standard library types it supports,
+/// hashes the bytes of types for which `poly::is_bitwise_comparable<T>` holds,
+/// and combines the element hashes of `std::vector<T>`. Overload
+/// `std::size_t call(poly::hash_, T const &)` for your own types.
+///
+/// To make an interface hashable, add the signature
+///
+///     std::size_t(poly::hash_, poly::self const &)
+///
+///
+/// Equality of interfaces
+/// ----------------------
+///
+/// For an interface with the signature
+///
+///     bool(poly::operator_eq_, poly::self const &, Interface const &)
+///
+/// this header implements the call for any `T` held in it: the result is true
+/// if the other operand holds a `T` too and the two values compare equal. For
+/// types with `poly::is_bitwise_comparable<T>`, the comparison is a `memcmp`.
+///
+///     struct key : poly::interface<key
+///         , std::size_t(poly::hash_, poly::self const &)
+///         , bool(poly::operator_eq_, poly::self const &, key const &)
+///         > { POLY_INTERFACE_CONSTRUCTORS(key); };
+///
+///     key a = 1, b = std::string("1");
+///     assert(!poly::operator_eq(a, b));
+///
+///
+/// Class template `poly::is_bitwise_comparable<T>`
+/// -----------------------------------------------
+///
+/// True if two values of `T` are equal exactly when their object
+/// representations are, i.e. `T` is trivially copyable, has no padding, and
+/// uses the built-in equality for all of its members. Holds for integers,
+/// enumerations and pointers; specialize for your own types as needed. It is
+/// never deduced for class types, since it overrides their `operator==` and
+/// `std::hash`.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/callable.hpp>
+#include <poly/interface.hpp>
+#include <poly/operators.hpp>
+#include <poly/detail/signatures_of.hpp>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace poly {
+
+POLY_CALLABLE(hash);
+
+template <typename T>
+struct is_bitwise_comparable : std::integral_constant<bool,
+    std::is_integral<T>::value || std::is_enum<T>::value ||
+    std::is_pointer<T>::value> {};
+
+namespace detail {
+
+inline std::size_t hash_bytes(void const * p, std::size_t n) noexcept {
+    // 64-bit FNV-1a, truncated to std::size_t.
+    unsigned char const * b = static_cast<unsigned char const *>(p);
+    unsigned long long h = 14695981039346656037ull;
+    for (std::size_t i = 0; i < n; ++i) {
+        h ^= b[i];
+        h *= 1099511628211ull;
+    }
+    return static_cast<std::size_t>(h);
+}
+
+inline std::size_t hash_combine(std::size_t seed, std::size_t h) noexcept {
+    return seed ^ (h + 0x9e3779b9 + (seed << 6) + (seed >> 2));
+}
+
+template <typename T>
+struct hashes_bytes : std::integral_constant<bool,
+    is_bitwise_comparable<T>::value && !std::is_scalar<T>::value> {};
+
+template <typename T>
+typename std::enable_if<is_bitwise_comparable<T>::value, bool>::type
+equal(T const & a, T const & b) noexcept {
+    return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template <typename T>
+typename std::enable_if<!is_bitwise_comparable<T>::value, bool>::type
+equal(T const & a, T const & b) {
+    return a == b;
+}
+
+} // detail
+
+template <typename T>
+inline auto call(hash_, T const & x)
+-> typename std::enable_if<!detail::hashes_bytes<T>::value,
+                           decltype(std::hash<T>()(x))>::type
+{
+    return std::hash<T>()(x);
+}
+
+template <typename T>
+inline auto call(hash_, T const & x)
+-> typename std::enable_if<detail::hashes_bytes<T>::value, std::size_t>::type
+{
+    return detail::hash_bytes(&x, sizeof(T));
+}
+
+template <typename T, typename A>
+inline auto call(hash_, std::vector<T, A> const & xs)
+-> decltype(poly::hash(std::declval<T const &>()))
+{
+    std::size_t h = xs.size();
+    for (auto const & x : xs) h = detail::hash_combine(h, poly::hash(x));
+    return h;
+}
+
+template <typename T, typename I>
+inline typename std::enable_if<
+    detail::is_interface<I>::value && !detail::is_interface<T>::value, bool
+    >::type
+call(operator_eq_, T const & a, I const & b) {
+    T const * p = poly::cast<T>(&b);
+    return p && detail::equal(a, *p);
+}
+
+} // poly
+
+#endif // POLY_HASH_HPP_J8C2NVW
@@ -20,6 +20,41 @@
 /// Class template `poly::interface<Signatures...>`
 /// -----------------------------------------------
 ///
+/// Where `noexcept` is part of the function type (C++17), a signature may be
+/// declared `noexcept`:
+///
+///     std::size_t(hash_, poly::self const &) noexcept
+///
+/// Calling it on the interface is then `noexcept` too, and it is a compile
+/// time error to hold a type whose `call` for it may throw. Converting the
+/// result to the return type must not throw either, or `std::terminate` is
+/// called.
+///
+/// **Code size.** Each type held costs a destructor, `copy()`, `data()`,
+/// `info()` and one function per signature; everything else is shared by all
+/// models. Models of types with the same layout compile to identical
+/// functions, which linkers with identical code folding merge (e.g.
+/// `-ffunction-sections -fuse-ld=gold -Wl,--icf=all`). `bench/code_size.sh`
+/// reports the cost per model and per signature.
+///
+///
+/// Class `poly::interface<>`
+/// -------------------------
+///
+/// With no signatures, `poly::interface<>` holds a copy of any copyable value,
+/// like `std::any`, retrievable with `poly::cast<T>`. Values of at most
+/// `buffer_size` bytes (by default `POLY_INTERFACE_BUFFER_SIZE`, i.e. four
+/// pointers, enough for a `std::string`), whose alignment divides
+/// `buffer_align`, and which have a non-throwing move constructor are
+/// guaranteed to be stored inline without allocation; `fits_inline<T>` tells
+/// whether that holds. Moves never throw. Type checks compare a single
+/// pointer.
+///
+///     poly::interface<> x = 1.5;
+///     assert(poly::cast<double>(x) == 1.5);
+///     assert(!poly::cast<int>(&x));
+///
+/// An empty `poly::interface<>` has `type() == typeid(void)`.
 ///
 ///
 /// Class template `poly::interface<Interface, Signatures...>`
@@ -59,21 +94,31 @@
 
 #include <poly/bad_cast.hpp>
 #include <poly/callable.hpp>
+#include <poly/failure.hpp>
+#include <poly/detail/allocate.hpp>
+#include <poly/detail/capabilities.hpp>
 #include <poly/detail/friends.hpp>
 #include <poly/detail/is_plain.hpp>
 #include <poly/detail/implement.hpp>
+#include <poly/detail/relocatable.hpp>
 #include <poly/detail/signatures.hpp>
+#include <poly/detail/storage.hpp>
 #include <poly/detail/strip.hpp>
 #include <poly/detail/config.hpp>
 #include <type_traits>
 #include <memory>
 #include <cassert>
 
+#ifndef POLY_INTERFACE_BUFFER_SIZE
+#define POLY_INTERFACE_BUFFER_SIZE (4 * sizeof(void *))
+#endif
+
 #define POLY_INTERFACE_CONSTRUCTORS(cls) /*****************/ \
     template <typename... A>                                 \
     cls(A &&... args)                                        \
     noexcept(noexcept(base(std::forward<A>(args)...)))       \
     : base(std::forward<A>(args)...) {}                      \
+    using base::operator=;                                   \
     typedef int POLY_DETAIL_CAT(POLY_CONSTRUCTOR_, __LINE__) \
     /**/
 
@@ -84,20 +129,14 @@ namespace poly {
 template <typename... Signatures> struct interface;
 
 
-// template <>
-// struct interface<> : interface<interface<>>
-// {
-//     typedef interface<interface<>> base;
-//     POLY_INTERFACE_CONSTRUCTORS(interface);
-// };
-
-
-template <typename R, typename F, typename... Args, typename... Sigs>
-struct interface<R(F, Args...), Sigs...>
-    : interface<interface<R(F, Args...), Sigs...>, R(F, Args...), Sigs...>
+template <typename R, typename F, typename... Args POLY_DETAIL_NX_PARAM,
+          typename... Sigs>
+struct interface<R(F, Args...) POLY_DETAIL_NX, Sigs...>
+    : interface<interface<R(F, Args...) POLY_DETAIL_NX, Sigs...>,
+                R(F, Args...) POLY_DETAIL_NX, Sigs...>
 {
-    typedef interface<interface<R(F, Args...), Sigs...>,
-                                R(F, Args...), Sigs...> base;
+    typedef interface<interface<R(F, Args...) POLY_DETAIL_NX, Sigs...>,
+                      R(F, Args...) POLY_DETAIL_NX, Sigs...> base;
     POLY_INTERFACE_CONSTRUCTORS(interface);
 };
 
@@ -108,42 +147,78 @@ struct interface<Interface, Signatures...>
 {
     typedef interface base;
 
-    struct concept
-#ifndef POLY_NO_MULTIPLE_INHERITANCE
-        : detail::signature<Signatures>...
-#else
-        : detail::signatures<detail::seq<Signatures...>>
-#endif
-    {
-        virtual ~concept() = default;
-        virtual concept * copy() const = 0;
+private:
+    template <typename I, typename... S> friend struct detail::friends;
+    struct adopt_ {};
+
+public:
+    // All the signatures are declared along a single inheritance chain, so
+    // that every model has exactly one vtable pointer.
+    struct concept_type : detail::signatures<detail::seq<Signatures...>> {
+        virtual ~concept_type() = default;
+        virtual concept_type * copy() const = 0;
         virtual void * data() noexcept = 0;
-        virtual void const * data() const noexcept = 0;
-        virtual std::type_info const & type() const noexcept = 0;
+        virtual detail::model_info const & info() const noexcept = 0;
+        // Overridden by the models of deferred types only.
+        virtual void dispose() noexcept { delete this; }
+        // Null, or a copy of a shared model to modify (see static_model.hpp).
+        virtual concept_type * unshare() const { return nullptr; }
+
+        // Non-virtual, so that models don't each need their own.
+        void const * data() const noexcept {
+            return const_cast<concept_type *>(this)->data();
+        }
+        detail::type_id const * tag() const noexcept { return info().tag; }
+        detail::capability_table const & capabilities() const noexcept {
+            return *info().capabilities;
+        }
     };
 
     template <typename T>
     struct model
-        : detail::implement<model<T>, concept, detail::signature<Signatures>...>
+        : detail::implement<model<T>,
+                            detail::disposing<T, model<T>, concept_type>,
+                            detail::signature<Signatures>...>
     {
         static_assert(detail::is_plain<T>::value, "unusable type!");
         model(T && x) : x(std::move(x)) {}
         template <typename... Args>
         explicit model(Args &&... args) : x(std::forward<Args>(args)...) {}
-        virtual concept * copy() const override { return new model(*this); }
+        virtual concept_type * copy() const override {
+            return new model(*this);
+        }
         virtual void * data() noexcept override { return &x; }
-        virtual void const * data() const noexcept override { return &x; }
-        virtual std::type_info const & type() const noexcept override {
-            return typeid(T);
+        virtual detail::model_info const & info() const noexcept override {
+            return detail::model_info_of<T>::value;
+        }
+        static void * operator new(std::size_t n) {
+            return detail::model_allocator<T>::allocate(n);
+        }
+        static void operator delete(void * p, std::size_t n) noexcept {
+            detail::model_allocator<T>::deallocate(p, n);
+        }
+#ifdef __cpp_aligned_new
+        static void * operator new(std::size_t n, std::align_val_t a) {
+            return ::operator new(n, a);
+        }
+        static void operator delete(void * p, std::size_t,
+                                    std::align_val_t a) noexcept {
+            ::operator delete(p, a);
+        }
+#endif
+        static Interface adopt(model * m) noexcept {
+            return Interface(adopt_(), m);
         }
         T x;
     };
 
     template <typename T, typename... Args>
     static interface make(Args &&... args) {
-        return interface(new model<T>(std::forward<Args>(args)...));
+        return interface(adopt_(),
+                         new model<T>(std::forward<Args>(args)...));
     }
 
+    interface(adopt_, concept_type * p) noexcept : p(p) {}
     interface() noexcept = default;
     interface(interface &&) noexcept = default;
     interface(interface const & x) : p(x.p->copy()) {}
@@ -156,36 +231,77 @@ struct interface<Interface, Signatures...>
         return *this;
     }
 
+    // Assign into the held value when it is a `T` too.
+    template <typename T, typename U=typename std::decay<T>::type>
+    typename std::enable_if<!detail::is_interface<U>::value &&
+                            !detail::converts_to<U, Interface>::value,
+                            interface &>::type
+    operator=(T && x) {
+        assign<U>(std::forward<T>(x), std::integral_constant<bool,
+            std::is_assignable<U &, T &&>::value>());
+        return *this;
+    }
+
+    // Values converting to `Interface` by themselves, e.g. static models.
+    template <typename T, typename U=typename std::decay<T>::type>
+    typename std::enable_if<detail::converts_to<U, Interface>::value,
+                            interface &>::type
+    operator=(T && x) {
+        Interface y = x.operator Interface();
+        p = std::move(static_cast<interface &>(y).p);
+        return *this;
+    }
+
     bool valid() const noexcept { return static_cast<bool>(p); }
 
-    concept & get() POLY_DETAIL_LREF noexcept {
+    concept_type & get() POLY_DETAIL_LREF {
         assert(valid());
+        own();
         return *p;
     }
-    concept const & get() const POLY_DETAIL_LREF noexcept {
+    concept_type const & get() const POLY_DETAIL_LREF noexcept {
         assert(valid());
         return *p;
     }
 #ifndef POLY_NO_REF_QUALIFIERS
-    concept && get() && noexcept {
+    concept_type && get() && {
         assert(valid());
+        own();
         return std::move(*p);
     }
 #endif
 
+#ifndef POLY_NO_RTTI
     std::type_info const & type() const noexcept {
         assert(valid());
-        return p->type();
+        return *p->tag()->info;
     }
-    void * data() noexcept { return get().data(); }
+#endif
+    void * data() { return get().data(); }
     void const * data() const noexcept { return get().data(); }
 
+    // The interfaces the held type declares (see <poly/interface_cast.hpp>).
+    detail::capability_table const & capabilities() const noexcept {
+        return get().capabilities();
+    }
+
+    template <typename T> bool holds() const noexcept {
+        return valid() && p->tag() == &detail::type_tag<T>::id;
+    }
+
+    template <typename T> T * target() {
+        return holds<T>() ? static_cast<T *>(data()) : nullptr;
+    }
+    template <typename T> T const * target() const noexcept {
+        return holds<T>() ? static_cast<T const *>(data()) : nullptr;
+    }
+
     template <typename T> T & get() POLY_DETAIL_LREF {
-        if (type() != typeid(T)) throw bad_cast();
+        if (!holds<T>()) detail::raise(bad_cast());
         return *static_cast<T *>(data());
     }
     template <typename T> T const & get() const POLY_DETAIL_LREF {
-        if (type() != typeid(T)) throw bad_cast();
+        if (!holds<T>()) detail::raise(bad_cast());
         return *static_cast<T const *>(data());
     }
 #ifndef POLY_NO_REF_QUALIFIERS
@@ -200,26 +316,197 @@ struct interface<Interface, Signatures...>
     }
 
 private:
-    explicit interface(concept * p) : p(p) {}
-    std::unique_ptr<concept> p;
+    template <typename U, typename T>
+    void assign(T && x, std::true_type) {
+        if (holds<U>())
+            *static_cast<U *>(data()) = std::forward<T>(x);
+        else
+            p.reset(new model<U>(std::forward<T>(x)));
+    }
+
+    template <typename U, typename T>
+    void assign(T && x, std::false_type) {
+        p.reset(new model<U>(std::forward<T>(x)));
+    }
+
+    // Trade a shared model for a copy of our own before modifying it.
+    void own() {
+        if (concept_type * q = p->unshare()) adopt_copy(q);
+    }
+
+    POLY_DETAIL_COLD void adopt_copy(concept_type * q) noexcept { p.reset(q); }
+
+    // Give up the model if `r` has adopted it.
+    void disown(interface const & r) noexcept {
+        if (r.p.get() == p.get()) p.release();
+    }
+
+    std::unique_ptr<concept_type, detail::model_deleter> p;
 };
 
 
+namespace detail {
+
+struct any_base {
+    virtual capability_table const & capabilities() const noexcept = 0;
+protected:
+    ~any_base() = default;
+};
+
+} // detail
+
+
+template <>
+struct interface<> {
+private:
+    struct in_place_ {};
+
+public:
+    static constexpr std::size_t buffer_size = POLY_INTERFACE_BUFFER_SIZE;
+    static constexpr std::size_t buffer_align = alignof(void *);
+
+    typedef detail::storable<detail::any_base, true> concept_type;
+
+    template <typename T>
+    struct model
+        : detail::stored<model<T>, concept_type, T,
+                         buffer_size, buffer_align, true>
+    {
+        static_assert(detail::is_plain<T>::value, "unusable type!");
+        static_assert(std::is_copy_constructible<T>::value,
+                      "poly::interface<> requires a copyable type");
+        model(T && x) : x(std::move(x)) {}
+        model(T const & x) : x(x) {}
+        template <typename... Args>
+        explicit model(in_place_, Args &&... args)
+        : x(std::forward<Args>(args)...) {}
+        virtual detail::capability_table const &
+        capabilities() const noexcept override {
+            return detail::capabilities_of<T>::value;
+        }
+        T x;
+    };
+
+    /// True if a value of type `T` is stored without allocation.
+    template <typename T>
+    struct fits_inline
+        : detail::fits_inline<T, buffer_size, buffer_align> {};
+
+    interface() noexcept = default;
+    interface(interface &&) noexcept = default;
+    interface(interface const &) = default;
+
+    template <typename T, typename Enable=typename std::enable_if<
+        !std::is_same<typename detail::strip<T>::type, interface>::value
+        >::type>
+    interface(T && x) {
+        s.template emplace<model<typename std::decay<T>::type>>(
+            std::forward<T>(x));
+    }
+
+    interface & operator=(interface &&) noexcept = default;
+    interface & operator=(interface const &) = default;
+
+    // Assign into the held value when it is a `T` too.
+    template <typename T, typename Enable=typename std::enable_if<
+        !std::is_same<typename detail::strip<T>::type, interface>::value
+        >::type>
+    interface & operator=(T && x) {
+        typedef typename std::decay<T>::type U;
+        assign<U>(std::forward<T>(x), std::integral_constant<bool,
+            std::is_assignable<U &, T &&>::value>());
+        return *this;
+    }
+
+    template <typename T, typename... Args>
+    T & emplace(Args &&... args) {
+        s.template emplace<model<T>>(in_place_(), std::forward<Args>(args)...);
+        return *static_cast<T *>(s.get()->data());
+    }
+
+    void reset() noexcept { s.reset(); }
+
+    void swap(interface & x) noexcept {
+        interface t(std::move(x));
+        x = std::move(*this);
+        *this = std::move(t);
+    }
+
+    bool valid() const noexcept { return s.valid(); }
+    bool is_local() const noexcept { return s.is_local(); }
+
+#ifndef POLY_NO_RTTI
+    std::type_info const & type() const noexcept {
+        return valid() ? *s.get()->tag()->info : typeid(void);
+    }
+#endif
+    void * data() noexcept { return valid() ? s.get()->data() : nullptr; }
+    void const * data() const noexcept {
+        return valid() ? s.get()->data() : nullptr;
+    }
+
+    // The interfaces the held type declares (see <poly/interface_cast.hpp>).
+    detail::capability_table const & capabilities() const noexcept {
+        assert(valid());
+        return s.get()->capabilities();
+    }
+
+    template <typename T> bool holds() const noexcept {
+        return valid() && s.get()->tag() == &detail::type_tag<T>::id;
+    }
+
+    template <typename T> T * target() noexcept {
+        return holds<T>() ? static_cast<T *>(s.get()->data()) : nullptr;
+    }
+    template <typename T> T const * target() const noexcept {
+        return holds<T>() ? static_cast<T const *>(s.get()->data()) : nullptr;
+    }
+
+    template <typename T> T & get() POLY_DETAIL_LREF {
+        if (T * p = target<T>()) return *p;
+        detail::raise(bad_cast());
+    }
+    template <typename T> T const & get() const POLY_DETAIL_LREF {
+        if (T const * p = target<T>()) return *p;
+        detail::raise(bad_cast());
+    }
+    template <typename T> T && move() {
+        return std::move(get<T>());
+    }
+
+private:
+    template <typename U, typename T>
+    void assign(T && x, std::true_type) {
+        if (U * p = target<U>()) *p = std::forward<T>(x);
+        else assign<U>(std::forward<T>(x), std::false_type());
+    }
+
+    // The new value is built before the old one, which `x` may be a part of,
+    // is destroyed.
+    template <typename U, typename T>
+    void assign(T && x, std::false_type) {
+        *this = interface(std::forward<T>(x));
+    }
+
+    detail::storage<concept_type, buffer_size, buffer_align> s;
+};
+
+inline void swap(interface<> & a, interface<> & b) noexcept { a.swap(b); }
+
+
 // -----------------------------------------------------------------------------
 
 
 template <typename T, typename... Sigs>
-inline T * cast(interface<Sigs...> * p) noexcept {
+inline T * cast(interface<Sigs...> * p) {
     assert(p);
-    if (p->type() != typeid(T)) return nullptr;
-    return static_cast<T *>(p->data());
+    return p->template target<T>();
 }
 
 template <typename T, typename... Sigs>
 inline T const * cast(interface<Sigs...> const * p) noexcept {
     assert(p);
-    if (p->type() != typeid(T)) return nullptr;
-    return static_cast<T const *>(p->data());
+    return p->template target<T>();
 }
 
 template <typename T, typename... Sigs>
@@ -237,6 +524,18 @@ inline T const & cast(interface<Sigs...> const & x) {
     return x.template get<T>();
 }
 
+template <typename T>
+inline T * cast(interface<> * p) noexcept {
+    assert(p);
+    return p->target<T>();
+}
+
+template <typename T>
+inline T const * cast(interface<> const * p) noexcept {
+    assert(p);
+    return p->target<T>();
+}
+
 
 } // poly
 
@@ -0,0 +1,72 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_INTERFACE_CAST_HPP_T9MB2WF
+#define POLY_INTERFACE_CAST_HPP_T9MB2WF
+
+/// Header <poly/interface_cast.hpp>
+/// ================================
+///
+/// Ask whether the value held in an interface implements another interface.
+///
+///
+/// Class template `poly::capabilities<T>`
+/// --------------------------------------
+///
+/// Lists the interfaces, besides the ones it is stored in, which `T` can be
+/// viewed as. Specialize it to derive from `poly::implements<Interfaces...>`:
+///
+///     namespace poly {
+///         template <> struct capabilities<circle>
+///             : implements<serializable, printable> {};
+///     }
+///
+/// The specialization must be visible wherever a `circle` is first stored in
+/// an interface. The tables for the listed interfaces are then built at
+/// compile time, along with the model, and it is a compile time error if
+/// `circle` lacks any of their signatures.
+///
+///
+/// Function template `poly::interface_cast<Other>(x)`
+/// --------------------------------------------------
+///
+/// A `poly::constant_ref<Other>` (see <poly/constant.hpp>) to the value held
+/// in the interface `x`, or an invalid one if the held type doesn't declare
+/// `Other` among its capabilities. Takes one virtual call and a scan of the
+/// capabilities of the held type, and never allocates.
+///
+///     example::drawable d = circle{1};
+///     if (auto s = poly::interface_cast<serializable>(d))
+///         save(s, out);
+///
+/// **Remark.** The result refers to the value in `x`: it is only usable while
+/// `x` holds the same value, and only the signatures taking
+/// `poly::self const &` or `poly::self` can be called through it.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/constant.hpp>
+#include <poly/interface.hpp>
+#include <poly/detail/capabilities.hpp>
+
+namespace poly {
+
+template <typename Other, typename... Sigs>
+inline constant_ref<Other> interface_cast(interface<Sigs...> const & x)
+noexcept
+{
+    typedef constant_ref<Other> result;
+    if (!x.valid()) return result();
+    void const * table =
+        x.capabilities().find(&detail::type_tag<Other>::id);
+    if (!table) return result();
+    return detail::constant_access::make<result>(x.data(),
+        static_cast<detail::constant_vtable<
+            typename detail::signatures_of<Other>::type> const *>(table));
+}
+
+} // poly
+
+#endif // POLY_INTERFACE_CAST_HPP_T9MB2WF
@@ -0,0 +1,187 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_INTERN_HPP_6YFQ0SD
+#define POLY_INTERN_HPP_6YFQ0SD
+
+/// Header <poly/intern.hpp>
+/// ========================
+///
+/// Hash-consing of immutable interface values.
+///
+///
+/// Class template `poly::interned<Interface>`
+/// ------------------------------------------
+///
+/// A shared, immutable, canonical instance of an interface value. Interning
+/// two equal values yields handles to the same instance, so equal leaves of a
+/// large document share one model, and comparing interned values is a pointer
+/// comparison. The hash is computed once and cached.
+///
+/// `Interface` needs the signatures (see <poly/hash.hpp>)
+///
+///     std::size_t(poly::hash_, poly::self const &)
+///     bool(poly::operator_eq_, poly::self const &, Interface const &)
+///
+/// **Example.**
+///
+///     poly::interned<key> a = key(std::string("abc"));
+///     poly::interned<key> b = key(std::string("abc"));
+///     assert(a == b && &a.get() == &b.get());
+///
+/// Interned values are also hashable (`poly::hash(a)`) and usable as keys of
+/// `std::unordered_map` via `std::hash<poly::interned<Interface>>`.
+///
+///
+/// Class template `poly::intern_table<Interface>`
+/// ----------------------------------------------
+///
+/// The table of canonical instances. It is safe to use from several threads
+/// at once; the table is split into independently locked shards by hash.
+/// The table only keeps weak references: a canonical instance is destroyed
+/// when its last `interned` handle is, and its slot is reclaimed lazily.
+/// `intern_table<Interface>::global()` is the table used by default.
+///
+/// **Remark.** A table must outlive the handles interned through it only as
+/// long as new values are interned; existing handles own their instance.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/hash.hpp>
+#include <poly/operators.hpp>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace poly {
+
+template <typename Interface> class interned;
+
+namespace detail {
+
+template <typename Interface> struct intern_node {
+    intern_node(Interface && x, std::size_t h) : value(std::move(x)), hash(h) {}
+    Interface const value;
+    std::size_t const hash;
+};
+
+} // detail
+
+template <typename Interface> class intern_table {
+    typedef detail::intern_node<Interface> node;
+
+public:
+    static constexpr std::size_t shards = 32;
+
+    intern_table() = default;
+    intern_table(intern_table const &) = delete;
+    intern_table & operator=(intern_table const &) = delete;
+
+    static intern_table & global() {
+        static intern_table t;
+        return t;
+    }
+
+    interned<Interface> intern(Interface x) {
+        std::size_t h = poly::hash(static_cast<Interface const &>(x));
+        shard & s = shard_for(h);
+        std::lock_guard<std::mutex> lock(s.m);
+        auto range = s.nodes.equal_range(h);
+        for (auto i = range.first; i != range.second;) {
+            if (auto p = i->second.lock()) {
+                if (operator_eq(static_cast<Interface const &>(x), p->value))
+                    return interned<Interface>(std::move(p));
+                ++i;
+            } else {
+                i = s.nodes.erase(i);
+            }
+        }
+        auto p = std::make_shared<node const>(std::move(x), h);
+        s.nodes.emplace(h, p);
+        if (s.nodes.size() >= s.sweep_at) sweep(s);
+        return interned<Interface>(std::move(p));
+    }
+
+    /// The number of slots in use, including not yet reclaimed ones.
+    std::size_t size() const {
+        std::size_t n = 0;
+        for (auto & s : table) {
+            std::lock_guard<std::mutex> lock(s.m);
+            n += s.nodes.size();
+        }
+        return n;
+    }
+
+private:
+    struct shard {
+        shard() : sweep_at(64) {}
+        mutable std::mutex m;
+        std::unordered_multimap<std::size_t, std::weak_ptr<node const>> nodes;
+        std::size_t sweep_at;
+    };
+
+    shard & shard_for(std::size_t h) noexcept {
+        return table[(h ^ (h >> 17) ^ (h >> 31)) % shards];
+    }
+
+    static void sweep(shard & s) {
+        for (auto i = s.nodes.begin(); i != s.nodes.end();) {
+            if (i->second.expired()) i = s.nodes.erase(i);
+            else ++i;
+        }
+        s.sweep_at = 2 * s.nodes.size() + 64;
+    }
+
+    shard table[shards];
+};
+
+template <typename Interface> class interned {
+    typedef detail::intern_node<Interface> node;
+    friend class intern_table<Interface>;
+    explicit interned(std::shared_ptr<node const> p) noexcept
+    : p(std::move(p)) {}
+
+public:
+    interned(Interface x,
+             intern_table<Interface> & t = intern_table<Interface>::global())
+    : interned(t.intern(std::move(x))) {}
+
+    Interface const & get() const noexcept { return p->value; }
+    operator Interface const &() const noexcept { return p->value; }
+    std::size_t hash() const noexcept { return p->hash; }
+
+    /// The number of handles sharing the canonical instance.
+    long use_count() const noexcept { return p.use_count(); }
+
+    friend bool operator==(interned const & a, interned const & b) noexcept {
+        return a.p == b.p;
+    }
+    friend bool operator!=(interned const & a, interned const & b) noexcept {
+        return a.p != b.p;
+    }
+
+    friend std::size_t call(hash_, interned const & x) noexcept {
+        return x.hash();
+    }
+
+private:
+    std::shared_ptr<node const> p;
+};
+
+} // poly
+
+namespace std {
+
+template <typename Interface> struct hash<poly::interned<Interface>> {
+    std::size_t operator()(poly::interned<Interface> const & x) const noexcept {
+        return x.hash();
+    }
+};
+
+} // std
+
+#endif // POLY_INTERN_HPP_6YFQ0SD
@@ -0,0 +1,250 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_LAZY_HPP_V5NQ3XK
+#define POLY_LAZY_HPP_V5NQ3XK
+
+/// Header <poly/lazy.hpp>
+/// ======================
+///
+/// Lazy, fused evaluation of operator expressions on interfaces.
+///
+///
+/// Function template `poly::lazy(x)`
+/// ---------------------------------
+///
+/// Wrap a reference to the interface `x` as the leaf of a lazy expression.
+/// Applying an operator callable of <poly/operators.hpp> to a lazy expression
+/// (and other lazy expressions or interfaces of the same type) does not call
+/// anything yet but builds a larger expression:
+///
+///     auto e = poly::operator_add(poly::operator_mul(poly::lazy(a), b), c);
+///
+/// **Remark.** Like other expression templates, lazy expressions only refer to
+/// their leaves, which must outlive the expression.
+///
+///
+/// Function template `poly::evaluate<Types...>(e)`
+/// -----------------------------------------------
+///
+/// Evaluate the lazy expression `e` into an interface. If all the leaves hold
+/// a value of the same type `T` listed in `Types...`, the whole expression is
+/// run on the concrete values after a single dispatch, and the result is
+/// converted back to a `T`. Otherwise, the expression is evaluated node by
+/// node through the signatures of the interface, e.g. with
+///
+///     number(poly::operator_add_, poly::self const &, number const &)
+///
+/// `poly::evaluate<Types...>(out, e)` assigns the result into `out` instead,
+/// reusing its model if it already holds a `T`.
+///
+///
+/// Class template `poly::is_lazy_operator<F>`
+/// ------------------------------------------
+///
+/// True for the callables which build lazy expressions: the arithmetic and
+/// bitwise operators of <poly/operators.hpp>. Specialize for other callables
+/// as needed.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/interface.hpp>
+#include <poly/operators.hpp>
+#include <poly/detail/indices.hpp>
+#include <poly/detail/signatures_of.hpp>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+
+namespace poly {
+
+template <typename F> struct is_lazy_operator : std::false_type {};
+
+template <> struct is_lazy_operator<operator_add_>    : std::true_type {};
+template <> struct is_lazy_operator<operator_sub_>    : std::true_type {};
+template <> struct is_lazy_operator<operator_mul_>    : std::true_type {};
+template <> struct is_lazy_operator<operator_div_>    : std::true_type {};
+template <> struct is_lazy_operator<operator_mod_>    : std::true_type {};
+template <> struct is_lazy_operator<operator_xor_>    : std::true_type {};
+template <> struct is_lazy_operator<operator_bitor_>  : std::true_type {};
+template <> struct is_lazy_operator<operator_bitand_> : std::true_type {};
+template <> struct is_lazy_operator<operator_lshift_> : std::true_type {};
+template <> struct is_lazy_operator<operator_rshift_> : std::true_type {};
+template <> struct is_lazy_operator<operator_compl_>  : std::true_type {};
+
+template <typename I> class lazy_ref {
+public:
+    explicit lazy_ref(I const & x) noexcept : p(&x) {}
+    I const & get() const noexcept { return *p; }
+private:
+    I const * p;
+};
+
+template <typename F, typename... Args> struct lazy_expr {
+    std::tuple<Args...> args;
+};
+
+template <typename I>
+inline typename std::enable_if<detail::is_interface<I>::value,
+                               lazy_ref<I>>::type
+lazy(I const & x) noexcept {
+    return lazy_ref<I>(x);
+}
+
+namespace detail {
+
+// --- lazy expression traits --------------------------------------------------
+
+template <typename T> struct is_lazy : std::false_type {};
+template <typename I> struct is_lazy<lazy_ref<I>> : std::true_type {};
+template <typename F, typename... Args>
+struct is_lazy<lazy_expr<F, Args...>> : std::true_type {};
+
+template <typename... T> struct any_lazy : std::false_type {};
+template <typename T, typename... More>
+struct any_lazy<T, More...> : std::integral_constant<bool,
+    is_lazy<T>::value || any_lazy<More...>::value> {};
+
+// An operand as stored in an expression node.
+template <typename T, typename Enable=void> struct lazy_operand {};
+template <typename T>
+struct lazy_operand<T, typename std::enable_if<is_lazy<T>::value>::type> {
+    typedef T type;
+    static T const & apply(T const & x) noexcept { return x; }
+};
+template <typename T>
+struct lazy_operand<T, typename std::enable_if<is_interface<T>::value>::type> {
+    typedef lazy_ref<T> type;
+    static lazy_ref<T> apply(T const & x) noexcept { return lazy_ref<T>(x); }
+};
+
+// The interface type of the leaves.
+template <typename E> struct lazy_interface;
+template <typename I> struct lazy_interface<lazy_ref<I>> { typedef I type; };
+template <typename F, typename A, typename... Args>
+struct lazy_interface<lazy_expr<F, A, Args...>> : lazy_interface<A> {};
+
+// --- fused evaluation on a concrete type T -----------------------------------
+
+template <typename T, typename I>
+inline bool lazy_holds(lazy_ref<I> const & e) noexcept {
+    return e.get().template holds<T>();
+}
+
+template <typename T, typename... Args, std::size_t... N>
+inline bool lazy_holds_all(std::tuple<Args...> const & args,
+                           indices<N...>) noexcept {
+    bool all = true;
+    bool expand[] = {true, (all = all && lazy_holds<T>(std::get<N>(args)))...};
+    (void)expand;
+    return all;
+}
+
+template <typename T, typename F, typename... Args>
+inline bool lazy_holds(lazy_expr<F, Args...> const & e) noexcept {
+    return lazy_holds_all<T>(e.args,
+        typename make_indices<sizeof...(Args)>::type());
+}
+
+template <typename T, typename E> struct fused;
+
+template <typename T, typename I> struct fused<T, lazy_ref<I>> {
+    typedef T const & type;
+    static T const & apply(lazy_ref<I> const & e) noexcept {
+        return *static_cast<T const *>(e.get().data());
+    }
+};
+
+template <typename T, typename F, typename... Args>
+struct fused<T, lazy_expr<F, Args...>> {
+    typedef decltype(std::declval<F const &>()(
+        std::declval<typename fused<T, Args>::type>()...)) type;
+
+    static type apply(lazy_expr<F, Args...> const & e) {
+        return apply(e, typename make_indices<sizeof...(Args)>::type());
+    }
+
+    template <std::size_t... N>
+    static type apply(lazy_expr<F, Args...> const & e, indices<N...>) {
+        return F()(fused<T, Args>::apply(std::get<N>(e.args))...);
+    }
+};
+
+// --- node by node evaluation -------------------------------------------------
+
+template <typename E> struct nodewise;
+
+template <typename I> struct nodewise<lazy_ref<I>> {
+    typedef I const & type;
+    static I const & apply(lazy_ref<I> const & e) noexcept { return e.get(); }
+};
+
+template <typename F, typename... Args>
+struct nodewise<lazy_expr<F, Args...>> {
+    typedef decltype(std::declval<F const &>()(
+        std::declval<typename nodewise<Args>::type>()...)) type;
+
+    static type apply(lazy_expr<F, Args...> const & e) {
+        return apply(e, typename make_indices<sizeof...(Args)>::type());
+    }
+
+    template <std::size_t... N>
+    static type apply(lazy_expr<F, Args...> const & e, indices<N...>) {
+        return F()(nodewise<Args>::apply(std::get<N>(e.args))...);
+    }
+};
+
+// --- dispatch over the candidate types ---------------------------------------
+
+template <typename... Types> struct lazy_dispatch;
+
+template <> struct lazy_dispatch<> {
+    template <typename I, typename E>
+    static void apply(I & out, E const & e) {
+        out = nodewise<E>::apply(e);
+    }
+};
+
+template <typename T, typename... Types> struct lazy_dispatch<T, Types...> {
+    template <typename I, typename E>
+    static void apply(I & out, E const & e) {
+        if (lazy_holds<T>(e))
+            out = T(fused<T, E>::apply(e));
+        else
+            lazy_dispatch<Types...>::apply(out, e);
+    }
+};
+
+} // detail
+
+template <typename F, typename... Args>
+inline typename std::enable_if<
+    is_lazy_operator<F>::value && detail::any_lazy<Args...>::value,
+    lazy_expr<F, typename detail::lazy_operand<Args>::type...>
+    >::type
+call(F, Args const &... args) {
+    return lazy_expr<F, typename detail::lazy_operand<Args>::type...>{
+        std::make_tuple(detail::lazy_operand<Args>::apply(args)...)};
+}
+
+template <typename... Types, typename E>
+inline typename std::enable_if<detail::is_lazy<E>::value>::type
+evaluate(typename detail::lazy_interface<E>::type & out, E const & e) {
+    detail::lazy_dispatch<Types...>::apply(out, e);
+}
+
+template <typename... Types, typename E>
+inline typename std::enable_if<detail::is_lazy<E>::value,
+                               typename detail::lazy_interface<E>::type>::type
+evaluate(E const & e) {
+    typename detail::lazy_interface<E>::type out;
+    detail::lazy_dispatch<Types...>::apply(out, e);
+    return out;
+}
+
+} // poly
+
+#endif // POLY_LAZY_HPP_V5NQ3XK
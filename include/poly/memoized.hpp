@@ -0,0 +1,296 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_MEMOIZED_HPP_W4RT7JB
+#define POLY_MEMOIZED_HPP_W4RT7JB
+
+/// Header <poly/memoized.hpp>
+/// ==========================
+///
+/// Caching the results of pure callables.
+///
+///
+/// Class template `poly::memoized<F>`
+/// ----------------------------------
+///
+/// A function object calling the callable `F` like `poly::callable<F>` does,
+/// i.e. `m(a, b)` calls `call(f, a, b)` found by ADL, but remembering the
+/// results: a call with arguments equal to those of an earlier call returns a
+/// copy of the earlier result without calling `F` again.
+///
+///     namespace text {
+///         POLY_CALLABLE(shape);
+///         glyphs call(shape_, std::string const & s, font const & f);
+///     }
+///
+///     static poly::memoized<text::shape_> shape;
+///     glyphs g = shape(title, bold);  // Shaped once for each (title, bold).
+///
+/// The results are keyed by the decayed types and values of the arguments,
+/// which are copied into the cache, so `F` must be pure and the arguments
+/// copyable, hashable by `poly::hash` and comparable by `poly::operator_eq`
+/// (or bitwise, see `poly::is_bitwise_comparable<T>`). An argument may be an
+/// interface with the signatures (see <poly/hash.hpp>)
+///
+///     std::size_t(poly::hash_, poly::self const &)
+///     bool(poly::operator_eq_, poly::self const &, Interface const &)
+///
+/// Pointers, such as string literals, are keyed by address.
+///
+/// The cache holds at most `capacity()` results, `memoized_capacity` unless
+/// given to the constructor. It is safe to use from several threads at once:
+/// the cache is split into independently locked shards by hash, and `F` is
+/// called without holding a lock, so it may call the same `memoized` again,
+/// e.g. recursively. When a shard is full, the result to drop is chosen by
+/// the CLOCK algorithm, an approximation of dropping the least recently used
+/// one. Two threads missing with the same arguments at once both call `F`,
+/// and only one of the results is kept.
+///
+/// **Remark.** Results are returned by value, copied under the lock of their
+/// shard. Return a `std::shared_ptr<T const>` from `F` if `T` is expensive to
+/// copy.
+///
+///
+/// Member functions
+/// ----------------
+///
+/// - `stats()` returns the `poly::memoized_stats` with the number of `hits`,
+///   `misses` and `evictions` so far, and the `size` of the cache.
+/// - `clear()` drops the cached results. The counters are kept.
+/// - `capacity()` returns the maximum number of cached results.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/callable.hpp>
+#include <poly/forward.hpp>
+#include <poly/hash.hpp>
+#include <poly/operators.hpp>
+#include <poly/detail/indices.hpp>
+#include <poly/detail/type_tag.hpp>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace poly {
+
+static constexpr std::size_t memoized_capacity = 4096;
+
+struct memoized_stats {
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t evictions;
+    std::size_t size;
+};
+
+namespace detail {
+
+struct memo_entry {
+    memo_entry(type_id const * tag, std::size_t hash) noexcept
+    : tag(tag), hash(hash), referenced(false) {}
+    virtual ~memo_entry() {}
+
+    type_id const * const tag;
+    std::size_t const hash;
+    bool referenced;  // Since the CLOCK hand last passed by.
+};
+
+template <typename Key, typename R> struct memo_node : memo_entry {
+    memo_node(std::size_t h, Key && k, R const & r)
+    : memo_entry(&type_tag<memo_node>::id, h), key(std::move(k)), result(r) {}
+
+    Key const key;
+    R const result;
+};
+
+typedef std::unique_ptr<memo_entry> memo_ptr;
+
+struct memo_shard {
+    memo_shard() : hand(0), hits(0), misses(0), evictions(0) {}
+
+    std::mutex m;
+    std::vector<memo_ptr> slots;  // The CLOCK, in insertion order.
+    std::unordered_multimap<std::size_t, std::size_t> index;  // Hash to slot.
+    std::size_t hand;
+    std::size_t hits;
+    std::size_t misses;
+    std::size_t evictions;
+};
+
+template <typename T>
+typename std::enable_if<is_bitwise_comparable<T>::value, bool>::type
+memo_equal(T const & a, T const & b) noexcept {
+    return detail::equal(a, b);
+}
+
+template <typename T>
+typename std::enable_if<!is_bitwise_comparable<T>::value, bool>::type
+memo_equal(T const & a, T const & b) {
+    return poly::operator_eq(a, b);
+}
+
+template <std::size_t I, typename Key>
+bool memo_equal_from(Key const &) noexcept { return true; }
+
+template <std::size_t I, typename Key, typename A, typename... As>
+bool memo_equal_from(Key const & k, A const & a, As const &... as) {
+    return memo_equal(std::get<I>(k), a) && memo_equal_from<I + 1>(k, as...);
+}
+
+// The argument `a` as it is keyed, e.g. a string literal as a pointer.
+template <typename A>
+typename std::decay<A>::type const &
+memo_arg(typename std::decay<A>::type const & a) noexcept {
+    return a;
+}
+
+inline std::size_t memo_hash(std::size_t h) noexcept { return h; }
+
+template <typename A, typename... As>
+std::size_t memo_hash(std::size_t h, A const & a, As const &... as) {
+    return memo_hash(hash_combine(h, poly::hash(a)), as...);
+}
+
+// The cached node in `s` with the arguments `args`, or null. Call locked.
+template <typename Node, typename... Args>
+Node * memo_find(memo_shard & s, std::size_t h, Args const &... args) {
+    auto range = s.index.equal_range(h);
+    for (auto i = range.first; i != range.second; ++i) {
+        memo_entry * e = s.slots[i->second].get();
+        if (e->tag != &type_tag<Node>::id) continue;
+        Node * n = static_cast<Node *>(e);
+        if (memo_equal_from<0>(n->key, args...)) return n;
+    }
+    return nullptr;
+}
+
+// Put `p` in `s`, returning the entry it replaced, if any. Call locked.
+inline memo_ptr memo_insert(memo_shard & s, memo_ptr p, std::size_t capacity) {
+    std::size_t const h = p->hash;
+    if (s.slots.size() < capacity) {
+        s.index.emplace(h, s.slots.size());
+        s.slots.push_back(std::move(p));
+        return nullptr;
+    }
+    while (s.slots[s.hand]->referenced) {
+        s.slots[s.hand]->referenced = false;
+        s.hand = (s.hand + 1) % s.slots.size();
+    }
+    auto range = s.index.equal_range(s.slots[s.hand]->hash);
+    for (auto i = range.first; i != range.second; ++i) {
+        if (i->second == s.hand) {
+            s.index.erase(i);
+            break;
+        }
+    }
+    s.index.emplace(h, s.hand);
+    p.swap(s.slots[s.hand]);
+    s.hand = (s.hand + 1) % s.slots.size();
+    ++s.evictions;
+    return p;
+}
+
+} // detail
+
+template <typename F> class memoized {
+public:
+    static constexpr std::size_t shards = 16;
+
+    explicit memoized(std::size_t capacity = memoized_capacity)
+    : per_shard(capacity > shards ? (capacity + shards - 1) / shards : 1) {}
+
+    memoized(memoized const &) = delete;
+    memoized & operator=(memoized const &) = delete;
+
+    template <typename... Args>
+    auto operator()(Args &&... args) const
+    -> typename std::decay<decltype(
+        call(std::declval<F const &>(), poly::forward<Args>(args)...))>::type
+    {
+        typedef typename std::decay<decltype(
+            call(std::declval<F const &>(), poly::forward<Args>(args)...))
+            >::type result_type;
+        typedef detail::memo_node<
+            std::tuple<typename std::decay<Args>::type...>, result_type> node;
+        static_assert(std::is_empty<F>::value,
+            "invalid callable -- F must be an empty (stateless) class");
+
+        std::size_t const h = detail::memo_hash(
+            sizeof...(Args), detail::memo_arg<Args>(args)...);
+        detail::memo_shard & s = shard_for(h);
+        {
+            std::lock_guard<std::mutex> lock(s.m);
+            if (node * n = detail::memo_find<node>(
+                    s, h, detail::memo_arg<Args>(args)...)) {
+                n->referenced = true;
+                ++s.hits;
+                return n->result;
+            }
+            ++s.misses;
+        }
+        // Copy the key first: the call may move from the arguments.
+        std::tuple<typename std::decay<Args>::type...> key(args...);
+        result_type r = call(F(), poly::forward<Args>(args)...);
+        std::unique_ptr<node> p(new node(h, std::move(key), r));
+        insert(s, std::move(p),
+               typename detail::make_indices<sizeof...(Args)>::type());
+        return r;
+    }
+
+    memoized_stats stats() const {
+        memoized_stats r = {0, 0, 0, 0};
+        for (auto & s : table) {
+            std::lock_guard<std::mutex> lock(s.m);
+            r.hits += s.hits;
+            r.misses += s.misses;
+            r.evictions += s.evictions;
+            r.size += s.slots.size();
+        }
+        return r;
+    }
+
+    void clear() {
+        for (auto & s : table) {
+            std::vector<detail::memo_ptr> dropped;
+            std::lock_guard<std::mutex> lock(s.m);
+            dropped.swap(s.slots);
+            s.index.clear();
+            s.hand = 0;
+        }
+    }
+
+    std::size_t capacity() const noexcept { return per_shard * shards; }
+
+private:
+    detail::memo_shard & shard_for(std::size_t h) const noexcept {
+        return table[(h ^ (h >> 17) ^ (h >> 31)) % shards];
+    }
+
+    template <typename Node, std::size_t... I>
+    void insert(detail::memo_shard & s, std::unique_ptr<Node> p,
+                detail::indices<I...>) const
+    {
+        // Destroyed after unlocking, in case destroying it takes a while.
+        detail::memo_ptr dropped;
+        std::lock_guard<std::mutex> lock(s.m);
+        if (detail::memo_find<Node>(s, p->hash, std::get<I>(p->key)...))
+            dropped = std::move(p);
+        else
+            dropped = detail::memo_insert(s, std::move(p), per_shard);
+    }
+
+    std::size_t const per_shard;
+    mutable detail::memo_shard table[shards];
+};
+
+template <typename F> constexpr std::size_t memoized<F>::shards;
+
+} // poly
+
+#endif // POLY_MEMOIZED_HPP_W4RT7JB
@@ -39,8 +39,38 @@
 ///     operator_ibitand
 ///     operator_ilshift
 ///     operator_irshift
+///
+///
+/// Operators on interfaces
+/// -----------------------
+///
+/// The arithmetic, bitwise and compound assignment callables above are also
+/// implemented for a value `a` of type `T` held in an interface and a right
+/// operand `b` of any interface type `I` (see also <poly/hash.hpp> for
+/// `operator_eq`). The operand `b` must hold a `T` too, or else
+/// `poly::bad_cast` is thrown:
+///
+/// - The compound assignments, like `operator_iadd(a, b)`, compute
+///   `a += poly::cast<T>(b)` in place.
+/// - The binary operators, like `operator_add(a, b)`, return
+///   `T(a + poly::cast<T>(b))`, or, if `a` is an rvalue, compute
+///   `a += poly::cast<T>(b)` in place and return `std::move(a)`.
+///
+/// Hence, with the signatures
+///
+///     void(poly::operator_iadd_, poly::self &, addable const &)
+///     addable(poly::operator_add_, poly::self, addable const &)
+///
+/// both `operator_iadd(sum, x)` and `sum = operator_add(std::move(sum), x)`
+/// update the model held by `sum` without allocating: a signature which
+/// consumes `poly::self` and returns the interface type reuses the model of
+/// `self` for a result of the same type.
 
 #include <poly/callable.hpp>
+#include <poly/interface.hpp>
+#include <poly/detail/signatures_of.hpp>
+#include <type_traits>
+#include <utility>
 
 #define POLY_UNARY_OPERATOR_CALL(name, op) /**/ \
     template <typename A>                       \
@@ -64,8 +94,47 @@
     POLY_BINARY_OPERATOR_CALL(name, op)     \
     /**/
 
+#define POLY_INTERFACE_OPERATOR_CALLS(name, op, iop) /*******************/ \
+    template <typename T, typename I, typename =                          \
+        decltype(std::declval<T const &>() op std::declval<T const &>())> \
+    inline typename std::enable_if<                                       \
+        detail::is_interface_operand<T, I>::value, T>::type               \
+    call(name##_, T const & a, I const & b) {                             \
+        return a op cast<T>(b);                                           \
+    }                                                                     \
+    template <typename T, typename I, typename =                          \
+        decltype(std::declval<T &>() iop std::declval<T const &>())>      \
+    inline typename std::enable_if<                                       \
+        detail::is_interface_operand<T, I>::value &&                      \
+        !std::is_reference<T>::value, T>::type                            \
+    call(name##_, T && a, I const & b) {                                  \
+        a iop cast<T>(b);                                                 \
+        return std::move(a);                                              \
+    }                                                                     \
+    /**/
+
+#define POLY_INTERFACE_COMPOUND_CALL(name, iop) /************************/ \
+    template <typename T, typename I, typename =                          \
+        decltype(std::declval<T &>() iop std::declval<T const &>())>      \
+    inline typename std::enable_if<                                       \
+        detail::is_interface_operand<T, I>::value, T &>::type             \
+    call(name##_, T & a, I const & b) {                                   \
+        a iop cast<T>(b);                                                 \
+        return a;                                                         \
+    }                                                                     \
+    /**/
+
 namespace poly {
 
+namespace detail {
+
+template <typename T, typename I>
+struct is_interface_operand : std::integral_constant<bool,
+    is_interface<I>::value &&
+    !is_interface<typename std::decay<T>::type>::value> {};
+
+} // detail
+
 POLY_BINARY_OPERATOR(operator_eq, ==);          // (a, b)  ~>  a == b
 POLY_BINARY_OPERATOR(operator_ne, !=);          // (a, b)  ~>  a != b
 POLY_BINARY_OPERATOR(operator_lt, <);           // (a, b)  ~>  a < b
@@ -107,6 +176,28 @@ POLY_BINARY_OPERATOR(operator_ibitand, &=);     // (a, b)  ~>  a &= b
 POLY_BINARY_OPERATOR(operator_ilshift, <<=);    // (a, b)  ~>  a <<= b
 POLY_BINARY_OPERATOR(operator_irshift, >>=);    // (a, b)  ~>  a >>= b
 
+POLY_INTERFACE_OPERATOR_CALLS(operator_add,    +,  +=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_sub,    -,  -=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_mul,    *,  *=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_div,    /,  /=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_mod,    %,  %=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_xor,    ^,  ^=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_bitor,  |,  |=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_bitand, &,  &=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_lshift, <<, <<=)
+POLY_INTERFACE_OPERATOR_CALLS(operator_rshift, >>, >>=)
+
+POLY_INTERFACE_COMPOUND_CALL(operator_iadd,    +=)
+POLY_INTERFACE_COMPOUND_CALL(operator_isub,    -=)
+POLY_INTERFACE_COMPOUND_CALL(operator_imul,    *=)
+POLY_INTERFACE_COMPOUND_CALL(operator_idiv,    /=)
+POLY_INTERFACE_COMPOUND_CALL(operator_imod,    %=)
+POLY_INTERFACE_COMPOUND_CALL(operator_ixor,    ^=)
+POLY_INTERFACE_COMPOUND_CALL(operator_ibitor,  |=)
+POLY_INTERFACE_COMPOUND_CALL(operator_ibitand, &=)
+POLY_INTERFACE_COMPOUND_CALL(operator_ilshift, <<=)
+POLY_INTERFACE_COMPOUND_CALL(operator_irshift, >>=)
+
 POLY_UNARY_OPERATOR(operator_incr, ++);         // (a)     ~>  ++a
 template <typename A, typename B>               // (a, 0)  ~>  a++
 constexpr auto call(operator_incr_, A && a, B && b)
@@ -0,0 +1,388 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_PERSISTENT_VECTOR_HPP_R7TQ2MB
+#define POLY_PERSISTENT_VECTOR_HPP_R7TQ2MB
+
+/// Header <poly/persistent_vector.hpp>
+/// ===================================
+///
+/// A value-semantic sequence with structural sharing between copies.
+///
+///
+/// Class template `poly::persistent_vector<T>`
+/// -------------------------------------------
+///
+/// A vector of `T` stored as a 32-way trie of reference counted nodes plus a
+/// separate tail node, as popularized by Clojure. Copying a
+/// `persistent_vector` is O(1) and only copies two pointers; `push_back`,
+/// `pop_back` and `set` are O(log32 n) and copy the nodes on the path from the
+/// root to the modified element, leaving other copies unaffected. Nodes which
+/// are not shared with any other copy are modified in place.
+///
+/// Because copies are cheap, a `persistent_vector` of interfaces makes a good
+/// document type: a snapshot of the document (e.g. for undo history) or a
+/// nested copy of it (`doc.push_back(doc)`) shares all of its elements with
+/// the original.
+///
+///     using document = poly::persistent_vector<example::drawable>;
+///
+///     document doc;
+///     doc.push_back(123);
+///     doc.push_back(std::string("a string!"));
+///     document undo = doc;        // O(1), no element is copied
+///     doc.push_back(doc);         // likewise, the nested copy is shared
+///     doc.set(0, 456);            // copies one path only; undo[0] is 123
+///
+/// **Remark.** The elements are immutable through the vector: element access
+/// returns `T const &`, and modifications go through `set(i, x)`.
+///
+/// **Remark.** Like any value, a single `persistent_vector` object must not be
+/// mutated concurrently. Distinct copies can be freely used from different
+/// threads, as the node reference counts are atomic.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/failure.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace poly {
+
+template <typename T> class persistent_vector {
+    static constexpr unsigned bits  = 5;
+    static constexpr std::size_t width = std::size_t(1) << bits;
+    static constexpr std::size_t mask  = width - 1;
+
+    struct node;
+    typedef std::shared_ptr<node> node_ptr;
+
+    struct node {
+        std::vector<node_ptr> children; // inner nodes
+        std::vector<T> values;          // leaves
+    };
+
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T const & reference;
+    typedef T const & const_reference;
+
+    class const_iterator;
+    typedef const_iterator iterator;
+
+    persistent_vector() noexcept : n(0), shift(bits) {}
+
+    persistent_vector(persistent_vector const &) = default;
+    persistent_vector & operator=(persistent_vector const &) = default;
+
+    // Moving leaves `x` empty.
+    persistent_vector(persistent_vector && x) noexcept : persistent_vector() {
+        swap(x);
+    }
+
+    persistent_vector & operator=(persistent_vector && x) noexcept {
+        persistent_vector(std::move(x)).swap(*this);
+        return *this;
+    }
+
+    persistent_vector(std::initializer_list<T> xs) : persistent_vector() {
+        for (auto & x : xs) push_back(x);
+    }
+
+    template <typename It>
+    persistent_vector(It first, It last) : persistent_vector() {
+        for (; first != last; ++first) push_back(*first);
+    }
+
+    size_type size() const noexcept { return n; }
+    bool empty() const noexcept { return n == 0; }
+
+    T const & operator[](size_type i) const noexcept {
+        assert(i < n);
+        return leaf_for(i)[i & mask];
+    }
+
+    T const & at(size_type i) const {
+        if (i >= n) detail::raise(std::out_of_range("persistent_vector::at"));
+        return (*this)[i];
+    }
+
+    T const & front() const noexcept { return (*this)[0]; }
+    T const & back() const noexcept { return (*this)[n - 1]; }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 0); }
+    const_iterator end() const noexcept { return const_iterator(this, n); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    void push_back(T x) {
+        if (n - tail_offset() < width) {
+            own(tail);
+            if (tail->values.empty()) tail->values.reserve(width);
+            tail->values.push_back(std::move(x));
+            ++n;
+            return;
+        }
+        // The tail is full: push it into the trie and start a new one.
+        node_ptr full = std::move(tail);
+        if ((n >> bits) > (std::size_t(1) << shift)) {
+            node_ptr r = std::make_shared<node>();
+            r->children.push_back(std::move(root));
+            r->children.push_back(new_path(shift, std::move(full)));
+            root = std::move(r);
+            shift += bits;
+        } else {
+            push_tail(root, shift, std::move(full));
+        }
+        tail = std::make_shared<node>();
+        tail->values.reserve(width);
+        tail->values.push_back(std::move(x));
+        ++n;
+    }
+
+    template <typename... Args>
+    void emplace_back(Args &&... args) {
+        push_back(T(std::forward<Args>(args)...));
+    }
+
+    void pop_back() {
+        assert(n > 0);
+        if (n == 1) {
+            *this = persistent_vector();
+            return;
+        }
+        if (n - tail_offset() > 1) {
+            own(tail);
+            tail->values.pop_back();
+            --n;
+            return;
+        }
+        // The tail becomes empty: pull the rightmost leaf out of the trie.
+        --n;
+        tail = trie_leaf_for(n - 1);
+        pop_tail(root, shift);
+        if (shift > bits && root && root->children.size() == 1) {
+            node_ptr r = root->children.front();
+            root = std::move(r);
+            shift -= bits;
+        }
+    }
+
+    void set(size_type i, T x) {
+        assert(i < n);
+        if (i >= tail_offset()) {
+            own(tail);
+            tail->values[i & mask] = std::move(x);
+            return;
+        }
+        node_ptr * p = &root;
+        for (unsigned s = shift; s > 0; s -= bits) {
+            own(*p);
+            p = &(*p)->children[(i >> s) & mask];
+        }
+        own(*p);
+        (*p)->values[i & mask] = std::move(x);
+    }
+
+    void clear() noexcept { *this = persistent_vector(); }
+
+    void swap(persistent_vector & other) noexcept {
+        using std::swap;
+        swap(n, other.n);
+        swap(shift, other.shift);
+        swap(root, other.root);
+        swap(tail, other.tail);
+    }
+
+    friend void swap(persistent_vector & a, persistent_vector & b) noexcept {
+        a.swap(b);
+    }
+
+    /// True if `a` and `b` share their whole structure, i.e. one is an
+    /// unmodified copy of the other. Constant time.
+    friend bool identical(persistent_vector const & a,
+                          persistent_vector const & b) noexcept
+    {
+        return a.n == b.n && a.root == b.root && a.tail == b.tail;
+    }
+
+private:
+    size_type tail_offset() const noexcept {
+        return n < width ? 0 : ((n - 1) >> bits) << bits;
+    }
+
+    node const & leaf_node_ref(size_type i) const noexcept {
+        if (i >= tail_offset()) return *tail;
+        node const * p = root.get();
+        for (unsigned s = shift; s > 0; s -= bits)
+            p = p->children[(i >> s) & mask].get();
+        return *p;
+    }
+
+    std::vector<T> const & leaf_for(size_type i) const noexcept {
+        return leaf_node_ref(i).values;
+    }
+
+    node_ptr trie_leaf_for(size_type i) const noexcept {
+        node_ptr const * p = &root;
+        for (unsigned s = shift; s > 0; s -= bits)
+            p = &(*p)->children[(i >> s) & mask];
+        return *p;
+    }
+
+    // Make sure `p` is not shared with any other vector before writing to it.
+    static void own(node_ptr & p) {
+        if (!p) p = std::make_shared<node>();
+        else if (p.use_count() > 1) p = std::make_shared<node>(*p);
+    }
+
+    static node_ptr new_path(unsigned s, node_ptr leaf) {
+        if (s == 0) return leaf;
+        node_ptr r = std::make_shared<node>();
+        r->children.push_back(new_path(s - bits, std::move(leaf)));
+        return r;
+    }
+
+    void push_tail(node_ptr & parent, unsigned s, node_ptr leaf) {
+        own(parent);
+        std::size_t i = ((n - 1) >> s) & mask;
+        if (s == bits) {
+            parent->children.push_back(std::move(leaf));
+        } else if (i < parent->children.size()) {
+            push_tail(parent->children[i], s - bits, std::move(leaf));
+        } else {
+            parent->children.push_back(new_path(s - bits, std::move(leaf)));
+        }
+    }
+
+    // Remove the rightmost leaf (the one holding index `n - 1` before the
+    // removal, i.e. `n` after it) from the subtree of `parent`.
+    void pop_tail(node_ptr & parent, unsigned s) {
+        own(parent);
+        std::size_t i = ((n - 1) >> s) & mask;
+        if (s > bits) {
+            pop_tail(parent->children[i], s - bits);
+            if (!parent->children[i]) parent->children.pop_back();
+        } else {
+            parent->children.pop_back();
+        }
+        if (parent->children.empty()) parent.reset();
+    }
+
+    size_type n;
+    unsigned shift;
+    node_ptr root;
+    node_ptr tail;
+};
+
+// --- persistent_vector<T>::const_iterator ------------------------------------
+
+template <typename T>
+class persistent_vector<T>::const_iterator {
+    friend class persistent_vector;
+    const_iterator(persistent_vector const * v, size_type i) noexcept
+    : v(v), i(i), leaf(nullptr), base(0) {}
+
+    T const & element() const noexcept {
+        if (!leaf || i < base || i >= base + width) {
+            leaf = &v->leaf_for(i);
+            base = i & ~mask;
+        }
+        return (*leaf)[i - base];
+    }
+
+public:
+    typedef std::random_access_iterator_tag iterator_category;
+    typedef T value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef T const * pointer;
+    typedef T const & reference;
+
+    const_iterator() noexcept : v(nullptr), i(0), leaf(nullptr), base(0) {}
+
+    reference operator*() const noexcept { return element(); }
+    pointer operator->() const noexcept { return &element(); }
+    reference operator[](difference_type d) const noexcept {
+        return (*v)[i + d];
+    }
+
+    const_iterator & operator++() noexcept { ++i; return *this; }
+    const_iterator & operator--() noexcept { --i; return *this; }
+    const_iterator operator++(int) noexcept { auto t = *this; ++i; return t; }
+    const_iterator operator--(int) noexcept { auto t = *this; --i; return t; }
+    const_iterator & operator+=(difference_type d) noexcept {
+        i += d;
+        return *this;
+    }
+    const_iterator & operator-=(difference_type d) noexcept {
+        i -= d;
+        return *this;
+    }
+
+    friend const_iterator operator+(const_iterator a, difference_type d) {
+        return a += d;
+    }
+    friend const_iterator operator+(difference_type d, const_iterator a) {
+        return a += d;
+    }
+    friend const_iterator operator-(const_iterator a, difference_type d) {
+        return a -= d;
+    }
+    friend difference_type operator-(const_iterator const & a,
+                                     const_iterator const & b) noexcept
+    {
+        return difference_type(a.i) - difference_type(b.i);
+    }
+
+    friend bool operator==(const_iterator const & a, const_iterator const & b) {
+        return a.i == b.i;
+    }
+    friend bool operator!=(const_iterator const & a, const_iterator const & b) {
+        return a.i != b.i;
+    }
+    friend bool operator<(const_iterator const & a, const_iterator const & b) {
+        return a.i < b.i;
+    }
+    friend bool operator>(const_iterator const & a, const_iterator const & b) {
+        return a.i > b.i;
+    }
+    friend bool operator<=(const_iterator const & a, const_iterator const & b) {
+        return a.i <= b.i;
+    }
+    friend bool operator>=(const_iterator const & a, const_iterator const & b) {
+        return a.i >= b.i;
+    }
+
+private:
+    persistent_vector const * v;
+    size_type i;
+    mutable std::vector<T> const * leaf;
+    mutable size_type base;
+};
+
+// -----------------------------------------------------------------------------
+
+template <typename T>
+inline auto begin(persistent_vector<T> const & v) -> decltype(v.begin()) {
+    return v.begin();
+}
+
+template <typename T>
+inline auto end(persistent_vector<T> const & v) -> decltype(v.end()) {
+    return v.end();
+}
+
+} // poly
+
+#endif // POLY_PERSISTENT_VECTOR_HPP_R7TQ2MB
@@ -0,0 +1,241 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_POOL_HPP_R2MV8QE
+#define POLY_POOL_HPP_R2MV8QE
+
+/// Header <poly/pool.hpp>
+/// ======================
+///
+/// Pooled allocation of interface models.
+///
+///
+/// Class template `poly::is_pooled<T>`
+/// -----------------------------------
+///
+/// Specialize as `std::true_type` to allocate the models of interfaces holding
+/// a `T` from the model pool instead of the global heap:
+///
+///     #include <poly/pool.hpp>
+///
+///     namespace poly {
+///         template <> struct is_pooled<message> : std::true_type {};
+///     }
+///
+/// The specialization must be visible before the first model of `T` is
+/// instantiated.
+///
+///
+/// The model pool
+/// --------------
+///
+/// Blocks are handed out by size class, in steps of `pool_granularity` bytes up
+/// to `pool_max_size`; larger (or over-aligned) models still go to the global
+/// heap. Each thread keeps its own free list per size class, so allocating
+/// and freeing take no locks. A thread that frees more blocks than it
+/// allocates, such as the consumer end of a queue, returns them to a shared
+/// depot in batches of `pool_batch` blocks, from where the allocating threads
+/// pick them up again one batch at a time. When a thread exits, its free
+/// blocks go back to the depot.
+///
+/// **Remark.** Memory is carved from `pool_slab_size` byte slabs which are
+/// never returned to the system.
+///
+///
+/// Functions `poly::pool_allocate(n)`, `poly::pool_deallocate(p, n)`
+/// ------------------------------------------------------------------
+///
+/// Allocate and free `n` bytes from the pool. `n` must be the same in both.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/detail/allocate.hpp>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace poly {
+
+static constexpr std::size_t pool_granularity = 16;
+static constexpr std::size_t pool_max_size = 256;
+static constexpr std::size_t pool_batch = 64;
+static constexpr std::size_t pool_slab_size = 64 * 1024;
+
+namespace detail {
+
+static constexpr std::size_t pool_classes = pool_max_size / pool_granularity;
+
+struct pool_block { pool_block * next; };
+
+struct pool_list {
+    pool_list() noexcept : head(nullptr), size(0) {}
+    pool_block * head;
+    std::size_t size;
+};
+
+// The shared depot of free blocks, in batches, plus the slabs they come from.
+class pool_depot {
+public:
+    static pool_depot & instance() {
+        // Never destroyed: models may be freed during static destruction.
+        static pool_depot * d = new pool_depot;
+        return *d;
+    }
+
+    // Fill the empty list `l` with blocks of size class `c`.
+    void refill(std::size_t c, pool_list & l) {
+        std::lock_guard<std::mutex> lock(m);
+        if (!batches[c].empty()) {
+            l = batches[c].back();
+            batches[c].pop_back();
+            return;
+        }
+        // Carve a new slab into batches; keep one and store the rest.
+        std::size_t size = (c + 1) * pool_granularity;
+        char * slab = static_cast<char *>(allocate(pool_slab_size));
+        slabs.push_back(slab);
+        std::size_t n = pool_slab_size / size;
+        for (std::size_t i = n; i-- > 0;) {
+            pool_block * b = reinterpret_cast<pool_block *>(slab + i * size);
+            b->next = l.head;
+            l.head = b;
+            if (++l.size == pool_batch && i > 0) {
+                batches[c].push_back(l);
+                l = pool_list();
+            }
+        }
+    }
+
+    void put(std::size_t c, pool_list l) noexcept {
+        std::lock_guard<std::mutex> lock(m);
+        POLY_DETAIL_TRY {
+            batches[c].push_back(l);
+        } POLY_DETAIL_CATCH_ALL {
+            // Out of memory: the blocks are lost, but stay valid.
+        }
+    }
+
+private:
+    pool_depot() = default;
+    std::mutex m;
+    std::vector<pool_list> batches[pool_classes];
+    std::vector<char *> slabs;
+};
+
+// The free lists of the current thread.
+class pool_cache {
+public:
+    // Null once the cache of the current thread has been destroyed, e.g. when
+    // another thread-local object frees a model after it.
+    static pool_cache * instance() {
+        if (destroyed()) return nullptr;
+        static thread_local pool_cache c;
+        return &c;
+    }
+
+    ~pool_cache() {
+        destroyed() = true;
+        for (std::size_t c = 0; c < pool_classes; ++c)
+            if (lists[c].head) pool_depot::instance().put(c, lists[c]);
+    }
+
+    void * allocate(std::size_t c) {
+        pool_list & l = lists[c];
+        if (!l.head) pool_depot::instance().refill(c, l);
+        pool_block * b = l.head;
+        l.head = b->next;
+        --l.size;
+        return b;
+    }
+
+    void deallocate(std::size_t c, void * p) noexcept {
+        pool_list & l = lists[c];
+        pool_block * b = static_cast<pool_block *>(p);
+        b->next = l.head;
+        l.head = b;
+        if (++l.size >= 2 * pool_batch) flush(c, l);
+    }
+
+private:
+    // Keep the `pool_batch` most recently freed blocks of `l` and return the
+    // rest to the depot.
+    static void flush(std::size_t c, pool_list & l) noexcept {
+        pool_block * last = l.head;
+        for (std::size_t i = 1; i < pool_batch; ++i) last = last->next;
+        pool_list rest;
+        rest.head = last->next;
+        rest.size = l.size - pool_batch;
+        last->next = nullptr;
+        l.size = pool_batch;
+        pool_depot::instance().put(c, rest);
+    }
+
+    static bool & destroyed() noexcept {
+        static thread_local bool d = false;
+        return d;
+    }
+
+    pool_list lists[pool_classes];
+};
+
+inline bool pool_fits(std::size_t n) noexcept {
+    return n != 0 && n <= pool_max_size;
+}
+
+inline std::size_t pool_class(std::size_t n) noexcept {
+    return (n - 1) / pool_granularity;
+}
+
+} // detail
+
+inline void * pool_allocate(std::size_t n) {
+    if (!detail::pool_fits(n)) return ::operator new(n);
+    std::size_t c = detail::pool_class(n);
+    if (detail::pool_cache * cache = detail::pool_cache::instance())
+        return cache->allocate(c);
+    detail::pool_list l;
+    detail::pool_depot::instance().refill(c, l);
+    void * p = l.head;
+    l.head = l.head->next;
+    --l.size;
+    if (l.head) detail::pool_depot::instance().put(c, l);
+    return p;
+}
+
+inline void pool_deallocate(void * p, std::size_t n) noexcept {
+    if (!detail::pool_fits(n)) return ::operator delete(p);
+    std::size_t c = detail::pool_class(n);
+    if (detail::pool_cache * cache = detail::pool_cache::instance())
+        return cache->deallocate(c, p);
+    detail::pool_list l;
+    l.head = static_cast<detail::pool_block *>(p);
+    l.head->next = nullptr;
+    l.size = 1;
+    detail::pool_depot::instance().put(c, l);
+}
+
+namespace detail {
+
+template <typename T> struct model_allocator<T, true> {
+    // Blocks are only aligned as well as the slabs and the block sizes allow.
+    typedef std::integral_constant<bool,
+        alignof(T) <= pool_granularity &&
+        alignof(T) <= alignof(std::max_align_t)> fits;
+
+    static void * allocate(std::size_t n) {
+        return fits::value ? pool_allocate(n) : detail::allocate(n);
+    }
+    static void deallocate(void * p, std::size_t n) noexcept {
+        if (fits::value) pool_deallocate(p, n);
+        else ::operator delete(p);
+    }
+};
+
+} // detail
+} // poly
+
+#endif // POLY_POOL_HPP_R2MV8QE
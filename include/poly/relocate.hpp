@@ -0,0 +1,189 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_RELOCATE_HPP_B1XW6TD
+#define POLY_RELOCATE_HPP_B1XW6TD
+
+/// Header <poly/relocate.hpp>
+/// ==========================
+///
+/// Move objects around by copying their bytes, when that is safe.
+///
+///
+/// Class template `poly::is_trivially_relocatable<T>`
+/// --------------------------------------------------
+///
+/// True if moving a `T` to a new address and destroying the original is
+/// equivalent to copying its bytes. Holds for trivially copyable types and for
+/// interfaces which only hold the pointer to their model, i.e. which add no
+/// data members to their `base`. Specialize it for your own types as needed.
+///
+/// With libstdc++ (GCC 9 or later), `std::vector<Interface>` is told about
+/// this too, so that it reallocates its elements with a single `memmove`
+/// instead of moving and destroying them one by one.
+///
+///
+/// Function template `poly::relocate(first, last, dest)`
+/// -----------------------------------------------------
+///
+/// Move the objects in `[first, last)` to the uninitialized storage starting
+/// at `dest`, and end the lifetime of the originals. Returns the end of the
+/// destination range. The ranges may overlap.
+///
+///
+/// Function templates `poly::insert(v, pos, x)`, `poly::erase(v, pos)`
+/// -------------------------------------------------------------------
+///
+/// Like `v.insert(pos, x)` and `v.erase(pos)` (or `v.erase(first, last)`) on a
+/// `std::vector`, but shift the tail with `memmove` if the element type is
+/// trivially relocatable.
+///
+///
+/// Function template `poly::sort(first, last, comp)`
+/// -------------------------------------------------
+///
+/// Sort a contiguous range of trivially relocatable objects by moving their
+/// bytes, so that no move constructor or destructor runs. The comparator must
+/// be `noexcept` for that, since the range would be left with duplicated
+/// objects if it threw; otherwise, and for other types, falls back to
+/// `std::sort`.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/detail/relocatable.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace poly {
+
+namespace detail {
+
+template <typename T>
+T * relocate(T * first, T * last, T * dest, std::true_type) noexcept {
+    std::size_t n = last - first;
+    if (n) {
+        std::memmove(static_cast<void *>(dest),
+                     static_cast<void const *>(first), n * sizeof(T));
+    }
+    return dest + n;
+}
+
+template <typename T>
+T * relocate(T * first, T * last, T * dest, std::false_type) {
+    if (dest <= first || dest >= last) {
+        for (; first != last; ++first, ++dest) {
+            ::new (static_cast<void *>(dest)) T(std::move(*first));
+            first->~T();
+        }
+        return dest;
+    }
+    T * end = dest + (last - first);
+    for (T * d = end; last != first;) {
+        --last; --d;
+        ::new (static_cast<void *>(d)) T(std::move(*last));
+        last->~T();
+    }
+    return end;
+}
+
+// The object representation of a `T`, copied around without running `T`'s
+// special member functions.
+template <typename T> struct relocatable_bytes {
+    T const & get() const noexcept {
+        return *reinterpret_cast<T const *>(&bytes);
+    }
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type bytes;
+};
+
+} // detail
+
+template <typename T>
+inline T * relocate(T * first, T * last, T * dest)
+noexcept(is_trivially_relocatable<T>::value ||
+         std::is_nothrow_move_constructible<T>::value)
+{
+    return detail::relocate(first, last, dest,
+        std::integral_constant<bool, is_trivially_relocatable<T>::value>());
+}
+
+template <typename T, typename A>
+inline typename std::vector<T, A>::iterator
+insert(std::vector<T, A> & v, typename std::vector<T, A>::const_iterator pos,
+       T x)
+{
+    if (!is_trivially_relocatable<T>::value)
+        return v.insert(pos, std::move(x));
+    std::size_t i = pos - v.cbegin();
+    v.push_back(std::move(x));
+    T * p = v.data();
+    std::size_t n = v.size() - 1;
+    if (i < n) {
+        // Shift `[i, n)` up by one, and put the new last element at `i`.
+        detail::relocatable_bytes<T> last;
+        std::memcpy(&last.bytes, static_cast<void const *>(p + n), sizeof(T));
+        std::memmove(static_cast<void *>(p + i + 1),
+                     static_cast<void const *>(p + i), (n - i) * sizeof(T));
+        std::memcpy(static_cast<void *>(p + i), &last.bytes, sizeof(T));
+    }
+    return v.begin() + i;
+}
+
+template <typename T, typename A>
+inline typename std::vector<T, A>::iterator
+erase(std::vector<T, A> & v, typename std::vector<T, A>::const_iterator first,
+      typename std::vector<T, A>::const_iterator last)
+{
+    if (!is_trivially_relocatable<T>::value) return v.erase(first, last);
+    std::size_t i = first - v.cbegin();
+    std::size_t k = last - first;
+    // Rotate the erased elements to the back as plain bytes, in place, then
+    // destroy them there.
+    typedef detail::relocatable_bytes<T> raw;
+    raw * p = reinterpret_cast<raw *>(v.data());
+    std::rotate(p + i, p + i + k, p + v.size());
+    for (; k > 0; --k) v.pop_back();
+    return v.begin() + i;
+}
+
+template <typename T, typename A>
+inline typename std::vector<T, A>::iterator
+erase(std::vector<T, A> & v, typename std::vector<T, A>::const_iterator pos) {
+    return poly::erase(v, pos, pos + 1);
+}
+
+template <typename T, typename Compare>
+void sort(T * first, T * last, Compare comp) {
+    // A comparator throwing halfway would leave duplicated and lost byte
+    // copies behind, so only one that cannot throw gets the fast path.
+    if (!is_trivially_relocatable<T>::value ||
+        !noexcept(comp(std::declval<T const &>(), std::declval<T const &>())))
+    {
+        std::sort(first, last, comp);
+        return;
+    }
+    // Let `std::sort` shuffle the objects as plain bytes: every move becomes
+    // a `memcpy`, and no move constructor or destructor runs. The comparator
+    // always sees a complete object, possibly at a temporary address.
+    typedef detail::relocatable_bytes<T> raw;
+    std::sort(reinterpret_cast<raw *>(first), reinterpret_cast<raw *>(last),
+              [&comp](raw const & a, raw const & b) {
+                  return comp(a.get(), b.get());
+              });
+}
+
+template <typename T, typename A, typename Compare>
+inline void sort(std::vector<T, A> & v, Compare comp) {
+    poly::sort(v.data(), v.data() + v.size(), comp);
+}
+
+} // poly
+
+#endif // POLY_RELOCATE_HPP_B1XW6TD
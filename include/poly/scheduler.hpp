@@ -0,0 +1,476 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_SCHEDULER_HPP_C5RT8WK
+#define POLY_SCHEDULER_HPP_C5RT8WK
+
+/// Header <poly/scheduler.hpp>
+/// ===========================
+///
+/// A work-stealing scheduler for large numbers of small tasks.
+///
+///
+/// Class `poly::scheduler`
+/// -----------------------
+///
+/// A fixed set of worker threads, each with a Chase-Lev deque of its own.
+/// A worker runs the tasks it spawned itself last in, first out, and when out
+/// of them, steals the oldest task of another worker. Tasks spawned from
+/// other threads go to a shared queue which idle workers take from.
+///
+/// A task is any function object callable as `f()` (a `poly::task` too). The
+/// slots of the deques hold the tasks inline, as models of an interface, so
+/// spawning a task of at most `POLY_SCHEDULER_TASK_SIZE` bytes whose move
+/// constructor doesn't throw allocates nothing. Larger ones go to the heap.
+///
+///     poly::scheduler s(4);
+///     s.spawn([&] { s.spawn(left); s.spawn(right); });
+///     s.wait();
+///
+/// - `spawn(f)` schedules `f`.
+/// - `spawn(f, then)` schedules `f`, and `then` once `f` and the tasks it
+///   spawned, theirs, and so on, have all returned. The continuation itself
+///   counts as one of the tasks spawned by the spawner of `f`.
+/// - `wait()` blocks until every task spawned so far has returned. It must
+///   not be called from a task; use a continuation there.
+/// - `poly::execute(s, task)` is `s.spawn(std::move(task))`.
+///
+/// The destructor waits, then stops the workers.
+///
+/// A task must not throw. When a deque already holds
+/// `scheduler_deque_size` tasks, a task spawned to it is run right away on
+/// the spawning thread instead.
+///
+///
+/// Macro `POLY_SCHEDULER_TASK_SIZE`
+/// --------------------------------
+///
+/// The size of a task stored inline, by default five pointers, enough for a
+/// `poly::task`. Define before including this header to override.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/function.hpp>
+#include <poly/thread_pool.hpp>
+#include <poly/detail/implement.hpp>
+#include <poly/detail/signatures.hpp>
+#include <poly/detail/storage.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#ifndef POLY_SCHEDULER_TASK_SIZE
+#define POLY_SCHEDULER_TASK_SIZE (5 * sizeof(void *))
+#endif
+
+namespace poly {
+
+static constexpr std::size_t scheduler_deque_size = 1024;
+
+namespace detail {
+
+// --- task_model<T> -----------------------------------------------------------
+
+typedef storable<signatures<seq<void(invoke_, self &)>>, false> task_concept;
+
+static constexpr std::size_t task_size = POLY_SCHEDULER_TASK_SIZE;
+static constexpr std::size_t task_align = alignof(void *);
+
+template <typename T>
+struct task_model
+    : implement<task_model<T>,
+                stored<task_model<T>, task_concept, T,
+                       task_size, task_align, false>,
+                signature<void(invoke_, self &)>>
+{
+    template <typename U>
+    explicit task_model(U && x) : x(std::forward<U>(x)) {}
+    T x;
+};
+
+typedef storage<task_concept, task_size, task_align> task_storage;
+
+// The most tasks a worker takes from the shared queue at a time.
+static constexpr std::size_t injected_batch = 64;
+
+// --- task_frame --------------------------------------------------------------
+
+// Counts the tasks of a `spawn(f, then)` still to return: `f`, and what it
+// spawned, recursively. At zero, `then` is spawned to the parent frame.
+struct task_frame {
+    explicit task_frame(task_frame * parent) : pending(1), parent(parent) {}
+    std::atomic<std::size_t> pending;
+    task_frame * parent;
+    task_storage then;
+};
+
+struct queued_task {
+    task_frame * frame;
+    task_storage task;
+};
+
+// --- task_deque<Capacity> ----------------------------------------------------
+
+// The Chase-Lev deque of `Capacity` tasks stored inline, with sequentially
+// consistent operations in place of the fences of Le et al. (2013). The owner
+// pushes and pops at the bottom, thieves steal from the top; a full deque
+// refuses more.
+//
+// A thief claims a task before moving it out of its slot, so each slot also
+// tells the index it is free for next. The owner waits for that before
+// reusing a slot which a thief may not have finished with.
+
+template <std::size_t Capacity>
+class task_deque {
+    static_assert(Capacity && (Capacity & (Capacity - 1)) == 0,
+                  "capacity must be a power of two");
+    static constexpr std::int64_t capacity = Capacity;
+
+public:
+    task_deque() : top(0), bottom(0) {
+        for (std::size_t i = 0; i < Capacity; ++i)
+            slots[i].next.store(std::int64_t(i), std::memory_order_relaxed);
+    }
+
+    task_deque(task_deque const &) = delete;
+    task_deque & operator=(task_deque const &) = delete;
+
+    // Owner only. Move `x` in, or return false if full.
+    bool push(queued_task & x) noexcept {
+        std::int64_t b = bottom.load(std::memory_order_relaxed);
+        std::int64_t t = top.load(std::memory_order_acquire);
+        if (b - t >= capacity) return false;
+        slot & s = slots[b & (capacity - 1)];
+        while (s.next.load(std::memory_order_acquire) != b)
+            std::this_thread::yield();
+        s.frame = x.frame;
+        s.task = std::move(x.task);
+        bottom.store(b + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Owner only. Move the newest task out to `x`.
+    bool pop(queued_task & x) noexcept {
+        std::int64_t b = bottom.load(std::memory_order_relaxed) - 1;
+        bottom.exchange(b, std::memory_order_seq_cst);
+        std::int64_t t = top.load(std::memory_order_seq_cst);
+        if (t > b) {
+            bottom.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+        std::int64_t next = b;
+        if (t == b) {
+            // The last task; thieves may be after it too.
+            bool won = top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom.store(b + 1, std::memory_order_relaxed);
+            if (!won) return false;
+            next = b + capacity;
+        }
+        take(b, next, x);
+        return true;
+    }
+
+    // Any thread. Move the oldest task out to `x`. May fail spuriously when
+    // racing another thread for it.
+    bool steal(queued_task & x) noexcept {
+        std::int64_t t = top.load(std::memory_order_seq_cst);
+        std::int64_t b = bottom.load(std::memory_order_seq_cst);
+        if (t >= b) return false;
+        if (!top.compare_exchange_strong(t, t + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed))
+            return false;
+        take(t, t + capacity, x);
+        return true;
+    }
+
+    bool empty() const noexcept {
+        return top.load(std::memory_order_acquire) >=
+               bottom.load(std::memory_order_acquire);
+    }
+
+private:
+    void take(std::int64_t i, std::int64_t next, queued_task & x) noexcept {
+        slot & s = slots[i & (capacity - 1)];
+        x.frame = s.frame;
+        x.task = std::move(s.task);
+        s.next.store(next, std::memory_order_release);
+    }
+
+    struct slot {
+        std::atomic<std::int64_t> next;
+        task_frame * frame;
+        task_storage task;
+    };
+
+    // Keep the thieves' end and the owner's end on separate cache lines.
+    std::atomic<std::int64_t> top;
+    char pad0[64 - sizeof(std::atomic<std::int64_t>)];
+    std::atomic<std::int64_t> bottom;
+    char pad1[64 - sizeof(std::atomic<std::int64_t>)];
+    slot slots[Capacity];
+};
+
+} // detail
+
+// -----------------------------------------------------------------------------
+
+class scheduler {
+    typedef detail::task_frame frame;
+    typedef detail::queued_task queued_task;
+
+    struct worker {
+        explicit worker(std::uint32_t seed) : random(seed | 1) {}
+        std::uint32_t next_random() noexcept {
+            random ^= random << 13;
+            random ^= random >> 17;
+            random ^= random << 5;
+            return random;
+        }
+        detail::task_deque<scheduler_deque_size> tasks;
+        std::uint32_t random;
+        std::thread thread;
+    };
+
+    // What the current thread is running, if it is a worker.
+    struct context {
+        scheduler * owner;
+        worker * local;
+        frame * current;
+    };
+
+public:
+    explicit scheduler(
+        std::size_t n = std::max(1u, std::thread::hardware_concurrency()))
+    : root(nullptr), injected_size(0), sleeping(0), waiting(0),
+      wakeups(0), stopping(false)
+    {
+        root.pending.store(0, std::memory_order_relaxed);
+        workers.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            workers.emplace_back(new worker(std::uint32_t(i * 2654435761u)));
+        for (auto & w : workers) {
+            worker * p = w.get();
+            p->thread = std::thread([this, p] { work(*p); });
+        }
+    }
+
+    scheduler(scheduler const &) = delete;
+    scheduler & operator=(scheduler const &) = delete;
+
+    ~scheduler() {
+        wait();
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopping = true;
+        }
+        ready.notify_all();
+        for (auto & w : workers) w->thread.join();
+    }
+
+    std::size_t size() const noexcept { return workers.size(); }
+
+    template <typename F>
+    void spawn(F && f) {
+        queued_task q;
+        q.task.template emplace<detail::task_model<
+            typename std::decay<F>::type>>(std::forward<F>(f));
+        q.frame = current_frame();
+        q.frame->pending.fetch_add(1, std::memory_order_relaxed);
+        push(q);
+    }
+
+    template <typename F, typename G>
+    void spawn(F && f, G && then) {
+        std::unique_ptr<frame> child(new frame(current_frame()));
+        child->then.template emplace<detail::task_model<
+            typename std::decay<G>::type>>(std::forward<G>(then));
+        queued_task q;
+        q.task.template emplace<detail::task_model<
+            typename std::decay<F>::type>>(std::forward<F>(f));
+        q.frame = child.release();
+        q.frame->parent->pending.fetch_add(1, std::memory_order_relaxed);
+        push(q);
+    }
+
+    void wait() {
+        assert(this_context().owner != this && "wait() called from a task");
+        std::unique_lock<std::mutex> lock(m);
+        waiting.fetch_add(1, std::memory_order_seq_cst);
+        done.wait(lock, [this] {
+            return root.pending.load(std::memory_order_seq_cst) == 0;
+        });
+        waiting.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    friend void call(execute_, scheduler & s, task t) {
+        s.spawn(std::move(t));
+    }
+
+private:
+    static context & this_context() noexcept {
+        static thread_local context c = {nullptr, nullptr, nullptr};
+        return c;
+    }
+
+    frame * current_frame() noexcept {
+        context & c = this_context();
+        return c.owner == this ? c.current : &root;
+    }
+
+    void push(queued_task & q) {
+        context & c = this_context();
+        if (c.owner == this) {
+            if (!c.local->tasks.push(q)) {
+                run(q);
+                return;
+            }
+        } else {
+            std::lock_guard<std::mutex> lock(m);
+            injected.push_back(std::move(q));
+            injected_size.fetch_add(1, std::memory_order_release);
+        }
+        wake();
+    }
+
+    // Wake a sleeping worker, if any.
+    //
+    // Both this and `idle()` update `sleeping` by a read-modify-write, so
+    // either the count read here includes a worker going to sleep, or that
+    // worker's increment comes later and synchronizes with the one here, so
+    // that it sees the task published before calling `wake()`.
+    void wake() {
+        if (sleeping.fetch_add(0, std::memory_order_acq_rel) == 0) return;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            ++wakeups;
+        }
+        ready.notify_one();
+    }
+
+    void run(queued_task & q) noexcept {
+        context & c = this_context();
+        frame * outer = c.current;
+        c.current = q.frame;
+        self s;
+        (*q.task.get())(detail::invoke, s);
+        q.task.reset();
+        c.current = outer;
+        complete(q.frame);
+    }
+
+    void complete(frame * f) noexcept {
+        if (f->pending.fetch_sub(1, std::memory_order_seq_cst) != 1) return;
+        if (f == &root) {
+            if (waiting.load(std::memory_order_seq_cst) == 0) return;
+            std::lock_guard<std::mutex> lock(m);
+            done.notify_all();
+            return;
+        }
+        // The count `f` held in its parent passes to the continuation.
+        queued_task q;
+        q.frame = f->parent;
+        q.task = std::move(f->then);
+        delete f;
+        push(q);
+    }
+
+    void work(worker & w) {
+        context & c = this_context();
+        c.owner = this;
+        c.local = &w;
+        c.current = &root;
+        queued_task q;
+        for (;;) {
+            if (w.tasks.pop(q) || steal(w, q)) run(q);
+            else if (!idle()) return;
+        }
+    }
+
+    bool steal(worker & w, queued_task & q) {
+        std::size_t n = workers.size();
+        std::size_t start = w.next_random() % n;
+        for (std::size_t i = 0; i < n; ++i) {
+            worker & v = *workers[(start + i) % n];
+            if (&v != &w && v.tasks.steal(q)) return true;
+        }
+        return take_injected(w, q);
+    }
+
+    // Take a task from the shared queue, and a share of the rest to the deque
+    // of `w`, where others may steal them.
+    bool take_injected(worker & w, queued_task & q) {
+        if (injected_size.load(std::memory_order_acquire) == 0) return false;
+        std::size_t taken = 0;
+        {
+            std::lock_guard<std::mutex> lock(m);
+            if (injected.empty()) return false;
+            q = std::move(injected.front());
+            injected.pop_front();
+            std::size_t share = std::min<std::size_t>(
+                injected.size() / workers.size(), detail::injected_batch);
+            while (taken < share && w.tasks.push(injected.front())) {
+                injected.pop_front();
+                ++taken;
+            }
+            injected_size.fetch_sub(taken + 1, std::memory_order_relaxed);
+        }
+        if (taken) wake();
+        return true;
+    }
+
+    bool has_work() const noexcept {
+        if (injected_size.load(std::memory_order_acquire)) return true;
+        for (auto & w : workers)
+            if (!w->tasks.empty()) return true;
+        return false;
+    }
+
+    // Spin a while, then sleep until woken. False once stopping.
+    bool idle() {
+        for (int i = 0; i < 64; ++i) {
+            if (has_work()) return true;
+            std::this_thread::yield();
+        }
+        std::unique_lock<std::mutex> lock(m);
+        if (stopping) return false;
+        std::size_t seen = wakeups;
+        lock.unlock();
+        sleeping.fetch_add(1, std::memory_order_acq_rel);
+        if (!has_work()) {
+            lock.lock();
+            ready.wait(lock, [&] { return stopping || wakeups != seen; });
+            lock.unlock();
+        }
+        sleeping.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    frame root;
+    std::vector<std::unique_ptr<worker>> workers;
+    std::mutex m;
+    std::condition_variable ready;
+    std::condition_variable done;
+    std::deque<queued_task> injected;
+    std::atomic<std::size_t> injected_size;
+    std::atomic<std::size_t> sleeping;
+    std::atomic<std::size_t> waiting;
+    std::size_t wakeups;
+    bool stopping;
+};
+
+} // poly
+
+#endif // POLY_SCHEDULER_HPP_C5RT8WK
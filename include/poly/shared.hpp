@@ -0,0 +1,276 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_SHARED_HPP_Q3HX8RD
+#define POLY_SHARED_HPP_Q3HX8RD
+
+/// Header <poly/shared.hpp>
+/// ========================
+///
+/// Read-only collections of interface values which can be placed in shared
+/// memory or in a mapped file, and used from several processes at once.
+///
+/// An interface holds a pointer to its model, and the model a pointer to its
+/// virtual table, neither of which means anything in another process or at
+/// another address. The collections here store instead, for each element, a
+/// small type id and the offset of its bytes from the start of the block.
+/// Each process maps the type ids back to tables of functions of its own
+/// through a `poly::type_registry`.
+///
+///
+/// Class template `poly::type_registry<Interface>`
+/// -----------------------------------------------
+///
+/// Assigns the ids `0, 1, 2, ...` to the types added to it with `add<T>()`,
+/// in order. The processes sharing a collection must add the same types in
+/// the same order, e.g. by running the same registration code before forking
+/// or in every executable. `fingerprint()` summarizes the registered types;
+/// it is stored in the collection and checked when the collection is opened.
+///
+/// The types must be trivially copyable, so that their bytes can be copied
+/// into the block and used from there as they are. Only the signatures taking
+/// `poly::self const &` or `poly::self` can be called on the elements, as with
+/// `poly::constant_ref` of <poly/constant.hpp>.
+///
+///
+/// Class template `poly::shared_builder<Interface>`
+/// ------------------------------------------------
+///
+/// Collects values with `push_back(x)`, then writes them with `write(dest)`
+/// into a block of `size_bytes()` bytes, aligned to `alignof(max_align_t)`.
+/// Throws `poly::bad_cast` for a type not in the registry.
+///
+///
+/// Class template `poly::shared_collection<Interface>`
+/// ---------------------------------------------------
+///
+/// A view of a block written by `shared_builder`. `operator[]` returns a
+/// `poly::constant_ref<Interface>` to the element in the block itself, without
+/// copying it. Throws `std::invalid_argument` if the block was not written
+/// with the same registered types.
+///
+///     poly::type_registry<shape> types;
+///     types.add<circle>();
+///     types.add<square>();
+///
+///     poly::shared_builder<shape> b(types);
+///     b.push_back(circle{1});
+///     b.push_back(square{2});
+///     void * block = map_shared_memory(b.size_bytes());
+///     b.write(block);
+///
+///     // In any process mapping the block, with the same registry:
+///     poly::shared_collection<shape> c(types, block);
+///     double a = area(c[1]);
+///
+/// **Remark.** The block must not change while it is in use.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/bad_cast.hpp>
+#include <poly/constant.hpp>
+#include <poly/failure.hpp>
+#include <poly/hash.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace poly {
+
+namespace detail {
+
+// The layout of a block. All positions are offsets from its start.
+
+struct shared_header {
+    std::uint64_t magic;
+    std::uint64_t fingerprint;
+    std::uint64_t count;
+};
+
+struct shared_entry {
+    std::uint32_t type;
+    std::uint32_t size;
+    std::uint64_t offset;
+};
+
+static constexpr std::uint64_t shared_magic = 0x31786f6c796c6f70ull;
+
+inline std::size_t shared_align(std::size_t n, std::size_t a) noexcept {
+    return (n + a - 1) / a * a;
+}
+
+// A name for `T` which is the same in every process running the program.
+template <typename T> char const * shared_type_name() noexcept {
+#ifndef POLY_NO_RTTI
+    return typeid(T).name();
+#elif defined(_MSC_VER)
+    return __FUNCSIG__;
+#else
+    return __PRETTY_FUNCTION__;
+#endif
+}
+
+} // detail
+
+// -----------------------------------------------------------------------------
+
+template <typename Interface>
+class type_registry {
+    typedef typename detail::signatures_of<Interface>::type signatures;
+
+public:
+    typedef detail::constant_vtable<signatures> vtable;
+
+    type_registry() : hash(detail::shared_magic) {}
+
+    template <typename T> std::uint32_t add() {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "only trivially copyable types can be shared");
+        auto it = ids.find(&detail::type_tag<T>::id);
+        if (it != ids.end()) return it->second;
+        std::uint32_t id = static_cast<std::uint32_t>(tables.size());
+        tables.push_back(&detail::constant_vtable_for<T, signatures>::value);
+        ids.emplace(&detail::type_tag<T>::id, id);
+        char const * name = detail::shared_type_name<T>();
+        std::size_t layout[] = {sizeof(T), alignof(T)};
+        hash = detail::hash_combine(hash,
+                   detail::hash_bytes(name, std::strlen(name)));
+        hash = detail::hash_combine(hash,
+                   detail::hash_bytes(layout, sizeof layout));
+        return id;
+    }
+
+    template <typename T> std::uint32_t id() const {
+        auto it = ids.find(&detail::type_tag<T>::id);
+        if (it == ids.end()) detail::raise(bad_cast());
+        return it->second;
+    }
+
+    std::size_t size() const noexcept { return tables.size(); }
+    std::uint64_t fingerprint() const noexcept { return hash; }
+
+    vtable const * table(std::uint32_t id) const noexcept {
+        return tables[id];
+    }
+
+private:
+    std::vector<vtable const *> tables;
+    std::unordered_map<detail::type_id const *, std::uint32_t> ids;
+    std::uint64_t hash;
+};
+
+// -----------------------------------------------------------------------------
+
+template <typename Interface>
+class shared_builder {
+public:
+    explicit shared_builder(type_registry<Interface> const & types)
+    : types(&types) {}
+
+    template <typename T> void push_back(T const & x) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "only trivially copyable types can be shared");
+        static_assert(alignof(T) <= alignof(std::max_align_t),
+                      "over-aligned types can't be shared");
+        detail::shared_entry e;
+        e.type = types->template id<T>();
+        e.size = static_cast<std::uint32_t>(sizeof(T));
+        e.offset = detail::shared_align(bytes.size(), alignof(T));
+        bytes.resize(e.offset + sizeof(T));
+        std::memcpy(&bytes[e.offset], &x, sizeof(T));
+        entries.push_back(e);
+    }
+
+    std::size_t size() const noexcept { return entries.size(); }
+
+    std::size_t size_bytes() const noexcept {
+        return data_offset() + bytes.size();
+    }
+
+    void write(void * dest) const noexcept {
+        unsigned char * d = static_cast<unsigned char *>(dest);
+        detail::shared_header h = {detail::shared_magic,
+                                   types->fingerprint(), entries.size()};
+        std::memcpy(d, &h, sizeof h);
+        std::size_t base = data_offset();
+        for (std::size_t i = 0; i < entries.size(); ++i) {
+            detail::shared_entry e = entries[i];
+            e.offset += base;
+            std::memcpy(d + sizeof h + i * sizeof e, &e, sizeof e);
+        }
+        if (!bytes.empty()) std::memcpy(d + base, bytes.data(), bytes.size());
+    }
+
+private:
+    std::size_t data_offset() const noexcept {
+        return detail::shared_align(sizeof(detail::shared_header) +
+            entries.size() * sizeof(detail::shared_entry),
+            alignof(std::max_align_t));
+    }
+
+    type_registry<Interface> const * types;
+    std::vector<detail::shared_entry> entries;
+    std::vector<unsigned char> bytes;
+};
+
+// -----------------------------------------------------------------------------
+
+template <typename Interface>
+class shared_collection {
+public:
+    typedef constant_ref<Interface> value_type;
+
+    shared_collection(type_registry<Interface> const & types,
+                      void const * block)
+    : types(&types), base(static_cast<unsigned char const *>(block))
+    {
+        detail::shared_header const & h = header();
+        if (h.magic != detail::shared_magic)
+            detail::raise(
+                std::invalid_argument("shared_collection: not a block"));
+        if (h.fingerprint != types.fingerprint())
+            detail::raise(
+                std::invalid_argument("shared_collection: type mismatch"));
+    }
+
+    std::size_t size() const noexcept {
+        return static_cast<std::size_t>(header().count);
+    }
+
+    bool empty() const noexcept { return size() == 0; }
+
+    value_type operator[](std::size_t i) const noexcept {
+        detail::shared_entry const & e = entry(i);
+        return detail::constant_access::make<value_type>(
+            base + e.offset, types->table(e.type));
+    }
+
+    value_type at(std::size_t i) const {
+        if (i >= size())
+            detail::raise(std::out_of_range("shared_collection::at"));
+        return (*this)[i];
+    }
+
+private:
+    detail::shared_header const & header() const noexcept {
+        return *reinterpret_cast<detail::shared_header const *>(base);
+    }
+
+    detail::shared_entry const & entry(std::size_t i) const noexcept {
+        return reinterpret_cast<detail::shared_entry const *>(
+            base + sizeof(detail::shared_header))[i];
+    }
+
+    type_registry<Interface> const * types;
+    unsigned char const * base;
+};
+
+} // poly
+
+#endif // POLY_SHARED_HPP_Q3HX8RD
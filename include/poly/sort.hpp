@@ -0,0 +1,251 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_SORT_HPP_R2KD9XA
+#define POLY_SORT_HPP_R2KD9XA
+
+/// Header <poly/sort.hpp>
+/// ======================
+///
+/// Sorting and searching ranges of interfaces by a concrete key.
+///
+/// Sorting a `std::vector<Interface>` with `std::sort` and an interface
+/// signature like `bool(poly::operator_lt_, poly::self const &, I const &)`
+/// dispatches twice per comparison. The functions of this header call the
+/// key callable `key(x)` once per element instead, and sort or partition the
+/// keys before moving the elements into place.
+///
+///     POLY_CALLABLE(area);
+///     struct shape : poly::interface<shape
+///         , double(area_, poly::self const &)
+///         > { POLY_INTERFACE_CONSTRUCTORS(shape); };
+///
+///     std::vector<shape> shapes = ...;
+///     poly::sort_by_key(shapes, area);
+///     auto i = poly::lower_bound_by_key(shapes, 1.0, area);
+///
+/// The range `r` is anything with random access `std::begin(r)` and
+/// `std::end(r)`, and `key` any function object taking an element. Moving
+/// the elements is assumed not to throw, as for interfaces.
+///
+///
+/// Function template `poly::sort_by_key(r, key)`
+/// ---------------------------------------------
+///
+/// Sort `r` stably by `key(x) < key(y)`. Keys of arithmetic and enumeration
+/// types are sorted by radix sort, in linear time, with `+0.0` and `-0.0`
+/// equal and NaNs placed first (if negative) or last (if positive). Other
+/// keys, e.g. `std::string`, are sorted with `std::sort`.
+///
+///
+/// Function template `poly::lower_bound_by_key(r, value, key)`
+/// -----------------------------------------------------------
+///
+/// The iterator to the first element `x` of `r` for which `key(x) < value`
+/// is false, `r` being partitioned so, e.g. by `sort_by_key(r, key)`.
+///
+///
+/// Function template `poly::partition_by_key(r, value, key)`
+/// ---------------------------------------------------------
+///
+/// Move the elements `x` of `r` for which `key(x) < value` before the others,
+/// stably, returning the iterator to the first of the others.
+
+// -----------------------------------------------------------------------------
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace poly {
+
+namespace detail {
+
+// The key `k` mapped to an unsigned integer of the same order, if `K` is
+// sortable by radix.
+template <typename K, typename = void> struct radix_key : std::false_type {};
+
+template <> struct radix_key<bool> : std::true_type {
+    typedef unsigned char type;
+    static type get(bool k) noexcept { return k; }
+};
+
+template <typename K>
+struct radix_key<K, typename std::enable_if<
+    std::is_integral<K>::value && !std::is_same<K, bool>::value>::type>
+: std::true_type
+{
+    typedef typename std::make_unsigned<K>::type type;
+    static type get(K k) noexcept {
+        return std::is_signed<K>::value
+            ? type(type(k) ^ (type(1) << (sizeof(type) * CHAR_BIT - 1)))
+            : type(k);
+    }
+};
+
+template <typename K>
+struct radix_key<K, typename std::enable_if<std::is_enum<K>::value>::type>
+: radix_key<typename std::underlying_type<K>::type>
+{
+    typedef radix_key<typename std::underlying_type<K>::type> base;
+    static typename base::type get(K k) noexcept {
+        return base::get(typename std::underlying_type<K>::type(k));
+    }
+};
+
+template <typename K>
+struct radix_key<K, typename std::enable_if<
+    std::is_floating_point<K>::value && std::numeric_limits<K>::is_iec559 &&
+    (sizeof(K) == 4 || sizeof(K) == 8)>::type>
+: std::true_type
+{
+    typedef typename std::conditional<sizeof(K) == 4,
+        std::uint32_t, std::uint64_t>::type type;
+    static type get(K k) noexcept {
+        k += K(0);  // -0.0 to +0.0
+        type u;
+        std::memcpy(&u, &k, sizeof(u));
+        type const sign = type(1) << (sizeof(type) * CHAR_BIT - 1);
+        return u & sign ? type(~u) : type(u | sign);
+    }
+};
+
+template <typename U> struct radix_item {
+    U key;
+    std::size_t index;
+};
+
+// Sort `a` stably by key, least significant byte first.
+template <typename U> void radix_sort(std::vector<radix_item<U>> & a) {
+    std::size_t const n = a.size();
+    std::size_t counts[sizeof(U)][256] = {};
+    for (auto const & x : a)
+        for (std::size_t d = 0; d < sizeof(U); ++d)
+            ++counts[d][(x.key >> (d * 8)) & 255];
+    std::vector<radix_item<U>> b(n);
+    for (std::size_t d = 0; d < sizeof(U); ++d) {
+        std::size_t * c = counts[d];
+        if (c[(a[0].key >> (d * 8)) & 255] == n) continue;  // All the same.
+        std::size_t sum = 0;
+        for (std::size_t i = 0; i < 256; ++i) {
+            std::size_t const k = c[i];
+            c[i] = sum;
+            sum += k;
+        }
+        for (auto const & x : a) b[c[(x.key >> (d * 8)) & 255]++] = x;
+        a.swap(b);
+    }
+}
+
+// Move the elements so that `first[i]` becomes what was `first[from[i]]`.
+// Leaves `from` as the identity.
+template <typename It>
+void permute(It first, std::vector<std::size_t> & from) {
+    typedef typename std::iterator_traits<It>::value_type value_type;
+    for (std::size_t i = 0; i < from.size(); ++i) {
+        if (from[i] == i) continue;
+        value_type x(std::move(first[i]));
+        std::size_t j = i;
+        while (from[j] != i) {
+            std::size_t const k = from[j];
+            first[j] = std::move(first[k]);
+            from[j] = j;
+            j = k;
+        }
+        first[j] = std::move(x);
+        from[j] = j;
+    }
+}
+
+template <typename It, typename Key>
+void sort_by_key(It first, std::size_t n, Key & key, std::true_type) {
+    typedef typename std::decay<decltype(key(*first))>::type K;
+    typedef typename radix_key<K>::type U;
+    std::vector<radix_item<U>> items(n);
+    for (std::size_t i = 0; i < n; ++i)
+        items[i] = radix_item<U>{radix_key<K>::get(key(first[i])), i};
+    radix_sort(items);
+    std::vector<std::size_t> from(n);
+    for (std::size_t i = 0; i < n; ++i) from[i] = items[i].index;
+    items = std::vector<radix_item<U>>();
+    permute(first, from);
+}
+
+template <typename It, typename Key>
+void sort_by_key(It first, std::size_t n, Key & key, std::false_type) {
+    typedef typename std::decay<decltype(key(*first))>::type K;
+    std::vector<std::pair<K, std::size_t>> items;
+    items.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) items.emplace_back(key(first[i]), i);
+    std::sort(items.begin(), items.end(),
+        [](std::pair<K, std::size_t> const & a,
+           std::pair<K, std::size_t> const & b)
+        {
+            return a.first < b.first ||
+                   (!(b.first < a.first) && a.second < b.second);
+        });
+    std::vector<std::size_t> from(n);
+    for (std::size_t i = 0; i < n; ++i) from[i] = items[i].second;
+    items = std::vector<std::pair<K, std::size_t>>();
+    permute(first, from);
+}
+
+} // detail
+
+template <typename R, typename Key>
+void sort_by_key(R && r, Key key) {
+    auto first = std::begin(r);
+    std::size_t const n = std::end(r) - first;
+    if (n < 2) return;
+    typedef typename std::decay<decltype(key(*first))>::type K;
+    detail::sort_by_key(first, n, key, detail::radix_key<K>());
+}
+
+template <typename R, typename T, typename Key>
+auto lower_bound_by_key(R && r, T const & value, Key key)
+-> decltype(std::begin(r))
+{
+    auto first = std::begin(r);
+    auto n = std::end(r) - first;
+    while (n > 0) {
+        auto const half = n / 2;
+        if (key(first[half]) < value) {
+            first += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return first;
+}
+
+template <typename R, typename T, typename Key>
+auto partition_by_key(R && r, T const & value, Key key)
+-> decltype(std::begin(r))
+{
+    auto first = std::begin(r);
+    std::size_t const n = std::end(r) - first;
+    std::vector<bool> below(n);
+    std::size_t m = 0;
+    for (std::size_t i = 0; i < n; ++i)
+        if (key(first[i]) < value) below[i] = true, ++m;
+    std::vector<std::size_t> from(n);
+    for (std::size_t i = 0, lo = 0, hi = m; i < n; ++i)
+        from[below[i] ? lo++ : hi++] = i;
+    below = std::vector<bool>();
+    detail::permute(first, from);
+    return first + m;
+}
+
+} // poly
+
+#endif // POLY_SORT_HPP_R2KD9XA
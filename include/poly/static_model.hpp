@@ -0,0 +1,93 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_STATIC_MODEL_HPP_W2JD6XA
+#define POLY_STATIC_MODEL_HPP_W2JD6XA
+
+/// Header <poly/static_model.hpp>
+/// ==============================
+///
+/// Interface values bound to program-lifetime constants.
+///
+///
+/// Class template `poly::static_model<Interface, T>`
+/// -------------------------------------------------
+///
+/// A model of `Interface` holding a `T`, meant to be a static variable, to
+/// which any number of `Interface` values can refer without owning it:
+///
+///     static poly::static_model<router, round_robin> const default_router;
+///
+///     router r = default_router;  // no allocation
+///     router s = r;               // no allocation either
+///
+/// The arguments of the constructor, if any, are passed to the constructor of
+/// `T`. Converting to `Interface`, copying the resulting values and
+/// destroying them only copy and drop a pointer. The model itself is never
+/// destroyed, so that values referring to it stay valid until the very end,
+/// even from the destructors of other static variables; the destructor of the
+/// `T` is not run at all.
+///
+/// The `T` is never modified. The first time a value referring to it is
+/// accessed through a non-`const` path, i.e. a `self &`, `self &&` or `self`
+/// signature, assignment, the non-`const` `data()`, `get()` or `poly::cast`,
+/// the value trades the reference for a copy of its own on the heap.
+///
+/// **Remark.** Only `poly::interface<Interface, Signatures...>` supports static
+/// models. `poly::interface<>` stores small values inline anyway.
+
+// -----------------------------------------------------------------------------
+
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace poly {
+
+template <typename Interface, typename T>
+class static_model {
+    typedef typename Interface::concept_type concept_type;
+    typedef typename Interface::template model<T> heap_model;
+
+    struct model : heap_model {
+        template <typename... Args>
+        explicit model(Args &&... args)
+        : heap_model(std::forward<Args>(args)...) {}
+
+        virtual concept_type * copy() const override {
+            return const_cast<model *>(this);
+        }
+        virtual void dispose() noexcept override {}
+        virtual concept_type * unshare() const override {
+            return new heap_model(static_cast<T const &>(this->x));
+        }
+    };
+
+public:
+    template <typename... Args>
+    explicit static_model(Args &&... args) {
+        ::new (static_cast<void *>(&buf)) model(std::forward<Args>(args)...);
+    }
+
+    static_model(static_model const &) = delete;
+    static_model & operator=(static_model const &) = delete;
+
+    operator Interface() const noexcept {
+        return heap_model::adopt(get());
+    }
+
+    T const & value() const noexcept { return get()->x; }
+
+private:
+    model * get() const noexcept {
+        return const_cast<model *>(reinterpret_cast<model const *>(&buf));
+    }
+
+    typename std::aligned_storage<sizeof(model), alignof(model)>::type buf;
+};
+
+} // poly
+
+#endif // POLY_STATIC_MODEL_HPP_W2JD6XA
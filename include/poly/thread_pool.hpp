@@ -0,0 +1,116 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_THREAD_POOL_HPP_E4HB1XN
+#define POLY_THREAD_POOL_HPP_E4HB1XN
+
+/// Header <poly/thread_pool.hpp>
+/// =============================
+///
+/// Executors: things that run tasks of type `poly::unique_function<void()>`.
+///
+///
+/// Callable `poly::execute(executor, task)`
+/// ----------------------------------------
+///
+/// Submit `task` for execution. Implement by overloading
+/// `void call(execute_, Executor &, poly::unique_function<void()>)`.
+///
+///
+/// Class `poly::thread_pool`
+/// -------------------------
+///
+/// A fixed-size pool of worker threads sharing one task queue. The destructor
+/// runs the remaining queued tasks before joining the workers.
+///
+///     poly::thread_pool pool(4);
+///     poly::execute(pool, [] { std::cout << "hello" << std::endl; });
+///
+///
+/// Class `poly::inline_executor`
+/// -----------------------------
+///
+/// Runs every task immediately on the calling thread.
+
+// -----------------------------------------------------------------------------
+
+#include <poly/callable.hpp>
+#include <poly/function.hpp>
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace poly {
+
+POLY_CALLABLE(execute);
+
+typedef unique_function<void()> task;
+
+class thread_pool {
+public:
+    explicit thread_pool(
+        std::size_t n = std::max(1u, std::thread::hardware_concurrency()))
+    : stopping(false)
+    {
+        workers.reserve(n);
+        for (std::size_t i = 0; i < n; ++i)
+            workers.emplace_back([this] { work(); });
+    }
+
+    thread_pool(thread_pool const &) = delete;
+    thread_pool & operator=(thread_pool const &) = delete;
+
+    ~thread_pool() {
+        {
+            std::lock_guard<std::mutex> lock(m);
+            stopping = true;
+        }
+        cv.notify_all();
+        for (auto & w : workers) w.join();
+    }
+
+    std::size_t size() const noexcept { return workers.size(); }
+
+    friend void call(execute_, thread_pool & p, task t) {
+        {
+            std::lock_guard<std::mutex> lock(p.m);
+            p.tasks.push_back(std::move(t));
+        }
+        p.cv.notify_one();
+    }
+
+private:
+    void work() {
+        for (;;) {
+            task t;
+            {
+                std::unique_lock<std::mutex> lock(m);
+                cv.wait(lock, [this] { return stopping || !tasks.empty(); });
+                if (tasks.empty()) return;
+                t = std::move(tasks.front());
+                tasks.pop_front();
+            }
+            t();
+        }
+    }
+
+    std::mutex m;
+    std::condition_variable cv;
+    std::deque<task> tasks;
+    bool stopping;
+    std::vector<std::thread> workers;
+};
+
+struct inline_executor {
+    friend void call(execute_, inline_executor &, task t) { t(); }
+};
+
+} // poly
+
+#endif // POLY_THREAD_POOL_HPP_E4HB1XN
@@ -0,0 +1,93 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/actor.hpp>
+#include <atomic>
+#include <cassert>
+#include <deque>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+POLY_CALLABLE(add);
+POLY_CALLABLE(value);
+POLY_CALLABLE(fail);
+
+struct counter : poly::interface<counter
+    , void(add_, poly::self &, long)
+    , long(value_, poly::self const &)
+    , std::string(fail_, poly::self const &, std::string const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(counter); };
+
+// Keeps the tasks until they are run one by one.
+struct stepper {
+    friend void call(poly::execute_, stepper & s, poly::task t) {
+        s.tasks.push_back(std::move(t));
+    }
+    std::deque<poly::task> tasks;
+};
+
+std::atomic<long> adds(0);
+
+void call(add_, long & x, long y) { x += y; ++adds; }
+long call(value_, long const & x) { return x; }
+std::string call(fail_, long const &, std::string const & s) {
+#ifndef POLY_NO_EXCEPTIONS
+    if (s.empty()) throw std::runtime_error("empty");
+#endif
+    return s;
+}
+
+int main() {
+    poly::thread_pool pool(4);
+    {
+        poly::actor<counter> c(pool, 0L);
+        std::vector<std::thread> threads;
+        for (int t = 0; t < 8; ++t) {
+            threads.emplace_back([&c] {
+                for (int i = 0; i < 10000; ++i) add(c, 1);
+            });
+        }
+        for (auto & t : threads) t.join();
+        assert(value(c).get() == 80000);
+
+        std::future<std::string> ok = fail(c, std::string("ok"));
+        assert(ok.get() == "ok");
+#ifndef POLY_NO_EXCEPTIONS
+        std::future<std::string> bad = fail(c, std::string());
+        try {
+            bad.get();
+            assert(false);
+        } catch (std::runtime_error const &) {}
+#endif
+    }
+
+    // Running everything on the calling thread works too.
+    poly::inline_executor now;
+    poly::actor<counter, poly::inline_executor> d(now, 1L);
+    add(d, 2);
+    assert(value(d).get() == 3);
+
+    // A drain task runs up to `batch` messages, then resubmits itself.
+    stepper s;
+    {
+        poly::actor<counter, stepper> e(s, 0L);
+        e.set_batch(3);
+        adds = 0;
+        for (int i = 0; i < 10; ++i) add(e, 1);
+        assert(s.tasks.size() == 1);
+        int drains = 0;
+        while (!s.tasks.empty()) {
+            poly::task t = std::move(s.tasks.front());
+            s.tasks.pop_front();
+            long const before = adds;
+            t();
+            assert(adds - before == (drains < 3 ? 3 : 1));
+            ++drains;
+        }
+        assert(drains == 4 && adds == 10);
+    }
+}
@@ -0,0 +1,157 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/any_range.hpp>
+#include <poly/interface.hpp>
+#include <cassert>
+#include <list>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace ns {
+
+// Counts from `first` to `last`, a chunk at a time.
+struct counter {
+    int first, last;
+    std::size_t calls;
+};
+
+std::size_t call(poly::next_chunk_, counter & c, int * out, std::size_t n) {
+    ++c.calls;
+    std::size_t k = 0;
+    for (; k < n && c.first != c.last; ++k) out[k] = c.first++;
+    return k;
+}
+
+// Counts the live instances, to check that chunks are cleaned up.
+struct tracked {
+    static int live;
+    explicit tracked(int v) : v(v) { ++live; }
+    tracked(tracked const & x) : v(x.v) {
+#ifndef POLY_NO_EXCEPTIONS
+        if (v < 0) throw std::runtime_error("negative");
+#endif
+        ++live;
+    }
+    ~tracked() { --live; }
+    int v;
+};
+int tracked::live = 0;
+
+POLY_CALLABLE(name);
+
+struct named : poly::interface<named
+    , std::string(name_, poly::self const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(named); };
+
+std::string call(name_, int x) { return std::to_string(x); }
+std::string call(name_, std::string const & s) { return s; }
+
+} // ns
+
+int main() {
+    using ns::counter;
+    using ns::tracked;
+
+    // Referring to an lvalue container.
+    {
+        std::vector<int> v(1000);
+        std::iota(v.begin(), v.end(), 0);
+        poly::any_range<int> r = v;
+        int expected = 0;
+        for (int x : r) assert(x == expected++);
+        assert(expected == 1000);
+        assert(r.begin() == r.end());
+    }
+
+    // Owning an rvalue container, with a chunk size of one.
+    {
+        poly::any_range<std::string, 1> r =
+            std::list<std::string>{"a", "b", "c"};
+        std::string s;
+        for (auto & x : r) s += std::move(x);
+        assert(s == "abc");
+    }
+
+    // A custom chunked source is called once per chunk, plus once for the end.
+    {
+        poly::any_range<int, 16> r = counter{0, 100, 0};
+        long sum = 0;
+        std::size_t chunks = 0;
+        r.for_each_chunk([&](int * first, int * last) {
+            ++chunks;
+            sum = std::accumulate(first, last, sum);
+        });
+        assert(sum == 4950);
+        assert(chunks == 7);
+        static_assert(
+            poly::detail::is_chunk_source<counter, int>::value, "");
+        static_assert(
+            !poly::detail::is_chunk_source<std::vector<int>, int>::value, "");
+    }
+
+    // Mixing iteration and for_each, and moving the range.
+    {
+        poly::any_range<int, 8> r = counter{0, 20, 0};
+        auto it = r.begin();
+        assert(*it == 0);
+        ++it;
+        ++it;
+        poly::any_range<int, 8> s = std::move(r);
+        assert(r.begin() == r.end());
+        int next = 2;
+        s.for_each([&](int x) { assert(x == next++); });
+        assert(next == 20);
+    }
+
+    // Ranges of interfaces.
+    {
+        std::vector<ns::named> v = {1, std::string("two"), 3};
+        poly::any_range<ns::named> r = v;
+        std::string s;
+        for (auto const & x : r) s += ns::name(x);
+        assert(s == "1two3");
+    }
+
+    // Chunks are destroyed when replaced or abandoned, and after a throw.
+    {
+        std::vector<tracked> v;
+        for (int i = 0; i < 10; ++i) v.emplace_back(i);
+        {
+            poly::any_range<tracked, 4> r = v;
+            auto it = r.begin();
+            assert(it->v == 0);
+            assert(tracked::live == 14);
+            ++it; ++it; ++it; ++it;
+            assert(it->v == 4 && tracked::live == 14);
+        }
+        assert(tracked::live == 10);
+#ifndef POLY_NO_EXCEPTIONS
+        v[6].v = -1;
+        poly::any_range<tracked, 4> r = v;
+        bool threw = false;
+        int seen = 0;
+        try {
+            for (auto & x : r) seen += x.v >= 0;
+        } catch (std::runtime_error const &) {
+            threw = true;
+        }
+        assert(threw && seen == 4);
+        assert(tracked::live == 10);
+#endif
+    }
+
+    // An empty range.
+    {
+        poly::any_range<int> r;
+        assert(r.begin() == r.end());
+        r.for_each([](int) { assert(false); });
+        poly::any_range<int> e = std::vector<int>();
+        assert(e.begin() == e.end());
+    }
+}
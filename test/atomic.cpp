@@ -0,0 +1,98 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/atomic.hpp>
+#include <poly/interface.hpp>
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+namespace ns {
+
+POLY_CALLABLE(route);
+
+struct router : poly::interface<router
+    , int(route_, poly::self const &, int)
+    > { POLY_INTERFACE_CONSTRUCTORS(router); };
+
+std::atomic<int> live(0);
+
+// Routes `key` to one of `n` targets; poisoned when destroyed.
+struct modulo {
+    explicit modulo(int n) : n(n), check(n) { ++live; }
+    modulo(modulo const & x) : n(x.n), check(x.check) { ++live; }
+    ~modulo() { n = check = -1; --live; }
+    int n, check;
+};
+
+int call(route_, modulo const & m, int key) {
+    assert(m.n > 0 && m.n == m.check);
+    return key % m.n;
+}
+
+} // ns
+
+int main() {
+    using ns::live;
+    using ns::modulo;
+    using ns::router;
+
+    {
+        poly::atomic<router> a(modulo(3));
+        assert(live == 1);
+        assert(ns::route(*a.load(), 10) == 1);
+
+        // Without snapshots, the replaced value goes right away.
+        a.store(modulo(4));
+        assert(live == 1);
+        assert(ns::route(*a.load(), 10) == 2);
+
+        // A snapshot keeps its value alive and unchanged.
+        {
+            auto s = a.load();
+            auto t = a.load();
+            a.store(modulo(5));
+            assert(live == 2);
+            assert(ns::route(*s, 10) == 2);
+            assert(ns::route(*t, 10) == 2);
+            assert(ns::route(*a.load(), 10) == 0);
+            auto u = std::move(t);
+            assert(ns::route(*u, 10) == 2);
+        }
+        a.store(modulo(6));
+        assert(live == 1);
+        assert(ns::route(*a.load(), 10) == 4);
+    }
+    assert(live == 0);
+
+    // Readers racing with a writer only ever see whole values.
+    {
+        poly::atomic<router> a(modulo(1));
+        std::atomic<bool> done(false);
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&] {
+                long sum = 0;
+                while (!done) {
+                    auto s = a.load();
+                    sum += ns::route(*s, 1000);
+                    auto t = a.load();
+                    sum += ns::route(*t, 1000);
+                }
+                assert(sum >= 0);
+            });
+        }
+        for (int n = 2; n < 2000; ++n) {
+            a.store(modulo(n));
+            if (n % 64 == 0) std::this_thread::yield();
+        }
+        done = true;
+        for (auto & t : readers) t.join();
+        a.store(modulo(1));
+        assert(live == 1);
+    }
+    assert(live == 0);
+}
@@ -0,0 +1,37 @@
+#!/bin/sh
+# Copyright 2012 Pyry Jahkola.
+#
+# Distributed under the Boost Software License, Version 1.0. (See accompanying
+# file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+# Build and run every test and example twice: as is, and without exceptions
+# and RTTI (`-fno-exceptions -fno-rtti`). Fails if any of them fails to build
+# or run. Run from anywhere; `CXX`, `CXXFLAGS` and `STD` select the build.
+
+set -e
+cd "$(dirname "$0")/.."
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--O1 -Wall -Wextra}
+STD=${STD:-c++17}
+out=$(mktemp -d "${TMPDIR:-/tmp}/poly_build_modes.XXXXXX")
+trap 'rm -rf "$out"' EXIT
+
+failed=0
+for mode in "" "-fno-exceptions -fno-rtti"; do
+    echo "$CXX -std=$STD $CXXFLAGS $mode"
+    for f in test/*.cpp example/*.cpp; do
+        if ! $CXX -std=$STD $CXXFLAGS $mode -pthread -Iinclude "$f" \
+                -o "$out/a.out" 2>"$out/log"; then
+            echo "  FAIL (build) $f"
+            cat "$out/log"
+            failed=1
+        elif ! "$out/a.out" </dev/null >"$out/log" 2>&1; then
+            echo "  FAIL (run) $f"
+            tail -20 "$out/log"
+            failed=1
+        else
+            echo "  ok $f"
+        fi
+    done
+done
+exit $failed
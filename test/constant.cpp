@@ -0,0 +1,83 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/constant.hpp>
+#include <poly/interface.hpp>
+#include <cassert>
+#include <string>
+#include <type_traits>
+
+POLY_CALLABLE(parse);
+POLY_CALLABLE(name);
+POLY_CALLABLE(scaled);
+POLY_CALLABLE(touch);
+
+struct handler : poly::interface<handler
+    , long(parse_, poly::self const &, std::string const &)
+    , char const *(name_, poly::self const &)
+    , long(scaled_, long, poly::self)
+    , void(touch_, poly::self &)
+    >
+{ POLY_INTERFACE_CONSTRUCTORS(handler); };
+
+struct decimal { int unused; };
+struct radix { int base; };
+
+long call(parse_, decimal const &, std::string const & s) {
+    return std::stol(s);
+}
+char const * call(name_, decimal const &) { return "decimal"; }
+long call(scaled_, long k, decimal) { return k; }
+void call(touch_, decimal &) {}
+
+long call(parse_, radix const & r, std::string const & s) {
+    return std::stol(s, nullptr, r.base);
+}
+char const * call(name_, radix const &) { return "radix"; }
+long call(scaled_, long k, radix r) { return k * r.base; }
+void call(touch_, radix &) {}
+
+typedef poly::constant_ref<handler> constant_handler;
+
+constexpr decimal dec{0};
+constexpr radix hex{16};
+constexpr radix bin{2};
+
+// Constant initialized: no dynamic initialization runs for the table.
+constexpr constant_handler handlers[] = {dec, hex, bin};
+
+static_assert(std::is_trivially_copyable<constant_handler>::value, "");
+static_assert(sizeof(constant_handler) == 2 * sizeof(void *), "");
+static_assert(handlers[1].valid(), "");
+static_assert(!constant_handler().valid(), "");
+static_assert(std::is_constructible<constant_handler, radix &>::value, "");
+static_assert(!std::is_constructible<constant_handler, radix>::value, "");
+static_assert(!std::is_constructible<constant_handler, radix const>::value,
+              "");
+static_assert(
+    std::is_constructible<constant_handler, constant_handler const>::value,
+    "");
+
+int main() {
+    assert(parse(handlers[0], "42") == 42);
+    assert(parse(handlers[1], "ff") == 255);
+    assert(parse(handlers[2], "101") == 5);
+    assert(std::string(name(handlers[0])) == "decimal");
+    assert(std::string(name(handlers[2])) == "radix");
+    assert(scaled(3, handlers[1]) == 48);
+
+    // Copies refer to the same object.
+    constant_handler h = handlers[1];
+    assert(h.target<radix>() == &hex);
+    assert(h.target<decimal>() == nullptr);
+#ifndef POLY_NO_RTTI
+    assert(h.type() == typeid(radix));
+    assert(constant_handler().type() == typeid(void));
+#endif
+
+    // The same objects still convert to owning interfaces.
+    handler x = hex;
+    assert(parse(x, "10") == 16);
+}
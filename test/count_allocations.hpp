@@ -0,0 +1,47 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef POLY_TEST_COUNT_ALLOCATIONS_HPP_T6MW1PE
+#define POLY_TEST_COUNT_ALLOCATIONS_HPP_T6MW1PE
+
+// Replaces the global `operator new` and `operator delete` to count the
+// allocations of the program, and the bytes allocated, in `allocations` and
+// `allocated`. Include in the one source file of a test or a benchmark.
+
+#include <poly/detail/config.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<std::size_t> allocations(0);
+static std::atomic<std::size_t> allocated(0);
+
+// GCC sees through the inlined operators and warns that memory from
+// `operator new` is passed to `std::free`, which is what they are for.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+void * operator new(std::size_t n) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated.fetch_add(n, std::memory_order_relaxed);
+    if (void * p = std::malloc(n ? n : 1)) return p;
+#ifndef POLY_NO_EXCEPTIONS
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+void operator delete(void * p) noexcept { std::free(p); }
+void operator delete(void * p, std::size_t) noexcept { std::free(p); }
+
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic pop
+#endif
+
+#endif // POLY_TEST_COUNT_ALLOCATIONS_HPP_T6MW1PE
@@ -0,0 +1,121 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/deferred.hpp>
+#include <poly/interface.hpp>
+#include <atomic>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+namespace ns {
+
+POLY_CALLABLE(size);
+
+struct sized : poly::interface<sized
+    , std::size_t(size_, poly::self const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(sized); };
+
+std::atomic<int> in_place(0);
+std::atomic<int> in_background(0);
+
+// Counts where the values which weren't moved from are destroyed.
+struct counted {
+    bool live;
+    counted() : live(true) {}
+    counted(counted const &) : live(true) {}
+    counted(counted && x) : live(x.live) { x.live = false; }
+    ~counted() {
+        if (!live) return;
+        if (poly::detail::on_reclaimer()) ++in_background;
+        else ++in_place;
+    }
+};
+
+// Destroyed in the background.
+struct node : counted {
+    std::vector<sized> children;
+};
+
+// Destroyed synchronously.
+struct leaf : counted {};
+
+// Keeps the reclaimer busy until released.
+std::atomic<bool> released(false);
+struct blocker {
+    ~blocker() {
+        if (!poly::detail::on_reclaimer()) return;
+        while (!released) std::this_thread::yield();
+    }
+};
+
+std::size_t call(size_, node const & n) { return n.children.size(); }
+std::size_t call(size_, leaf const &) { return 0; }
+std::size_t call(size_, blocker const &) { return 0; }
+
+void reset() { in_place = in_background = 0; }
+
+} // ns
+
+namespace poly {
+template <> struct is_deferred<ns::node> : std::true_type {};
+template <> struct is_deferred<ns::blocker> : std::true_type {};
+} // poly
+
+int main() {
+    using namespace ns;
+
+    static_assert(poly::is_deferred<node>::value, "");
+    static_assert(!poly::is_deferred<leaf>::value, "");
+
+    // Other types are destroyed right away.
+    { sized x = leaf(); }
+    assert(in_place == 1 && in_background == 0);
+    reset();
+
+    // A deferred model waits for its batch, then its whole tree is destroyed
+    // by the reclaimer.
+    {
+        node root;
+        for (int i = 0; i < 10; ++i) {
+            node child;
+            child.children.emplace_back(leaf());
+            root.children.emplace_back(std::move(child));
+        }
+        sized x = std::move(root);
+        assert(size(x) == 10);
+    }
+    assert(in_place == 0 && in_background == 0);
+    poly::drain_deferred();
+    assert(in_place == 0);
+    assert(in_background == 1 + 10 + 10);
+    reset();
+
+    // Full batches are handed over without flushing.
+    for (std::size_t i = 0; i < poly::deferred_batch; ++i) sized x = node();
+    poly::detail::reclaimer::instance()->drain();
+    assert(in_background == int(poly::deferred_batch));
+    reset();
+
+    // Models dropped by other threads, also at thread exit.
+    std::thread([] { sized x = node(); }).join();
+    poly::drain_deferred();
+    assert(in_background == 1);
+    reset();
+
+    // When the queue is full, models are destroyed synchronously.
+    {
+        sized b = blocker();
+        poly::flush_deferred();
+    }
+    poly::flush_deferred();
+    std::size_t const n = (poly::deferred_queue_size + 2) *
+                          poly::deferred_batch;
+    for (std::size_t i = 0; i < n; ++i) sized x = node();
+    assert(in_place >= int(poly::deferred_batch));
+    released = true;
+    poly::drain_deferred();
+    assert(in_place + in_background == int(n));
+}
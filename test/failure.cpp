@@ -0,0 +1,93 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// Checked access, and failures with and without exceptions. Build with
+// `-fno-exceptions -fno-rtti` too.
+
+#include <poly/failure.hpp>
+#include <poly/interface.hpp>
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <string>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace ns {
+
+POLY_CALLABLE(name);
+
+struct named : poly::interface<named
+    , std::string(name_, poly::self const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(named); };
+
+std::string call(name_, int) { return "int"; }
+std::string call(name_, double) { return "double"; }
+
+int calls = 0;
+void count(char const *) { ++calls; }
+
+// Exits with a status telling which failure was reported.
+void report(char const * what) {
+    std::_Exit(std::strstr(what, "bad_cast") ? 10 :
+               std::strstr(what, "bad_alloc") ? 11 : 1);
+}
+
+// The exit status of `f()` run in a child process.
+template <typename F> int status_of(F f) {
+    pid_t pid = fork();
+    if (pid == 0) {
+        f();
+        std::_Exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    return WIFEXITED(status) ? WEXITSTATUS(status) : -1;
+}
+
+} // ns
+
+int main() {
+    ns::named x = 1;
+    poly::interface<> y = 2.5;
+
+    // Checked access never fails.
+    assert(x.holds<int>() && !x.holds<double>());
+    assert(x.target<int>() && *x.target<int>() == 1);
+    assert(!x.target<double>());
+    assert(!poly::cast<double>(&x) && !poly::cast<int>(&y));
+    assert(*poly::cast<double>(&y) == 2.5);
+    assert(ns::name(x) == "int");
+
+    assert(poly::get_failure_handler() == nullptr);
+    assert(poly::set_failure_handler(&ns::count) == nullptr);
+    assert(poly::get_failure_handler() == &ns::count);
+
+#ifndef POLY_NO_EXCEPTIONS
+    // With exceptions, failures throw and the handler is left alone.
+    bool threw = false;
+    try { x.get<double>(); } catch (poly::bad_cast const &) { threw = true; }
+    assert(threw && ns::calls == 0);
+    threw = false;
+    try {
+        poly::detail::allocate(std::size_t(-1) / 2);
+    } catch (std::bad_alloc const &) {
+        threw = true;
+    }
+    assert(threw && ns::calls == 0);
+#else
+    // Without, the handler is called, and then the program aborted.
+    assert(ns::status_of([&] { poly::cast<int>(y); }) == -1);
+    assert(ns::calls == 0);
+    poly::set_failure_handler(&ns::report);
+    assert(ns::status_of([&] { x.get<double>(); }) == 10);
+    assert(ns::status_of([&] { poly::cast<int>(y); }) == 10);
+    assert(ns::status_of([] {
+        poly::detail::allocate(std::size_t(-1) / 2);
+    }) == 11);
+#endif
+    poly::set_failure_handler(nullptr);
+}
@@ -0,0 +1,97 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/function.hpp>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+struct show {
+    std::string operator()(int i) const { return "int " + std::to_string(i); }
+    std::string operator()(std::string const & s) const { return "str " + s; }
+};
+
+struct counter {
+    int n = 0;
+    int operator()() { return ++n; }
+};
+
+struct big { char bytes[64]; int operator()() const { return bytes[0]; } };
+
+// Exactly fills the buffer.
+struct full {
+    std::ptrdiff_t a, b, c;
+    std::ptrdiff_t operator()() const { return a + b + c; }
+};
+
+int main() {
+    typedef poly::function<std::string(int),
+                           std::string(std::string const &)> shower;
+    static_assert(std::is_nothrow_move_constructible<shower>::value, "");
+    static_assert(shower::fits_inline<show>::value, "");
+    static_assert(!shower::fits_inline<big>::value, "");
+
+    shower f = show();
+    assert(f(1) == "int 1");
+    assert(f(std::string("a")) == "str a");
+    shower g = f;
+    shower h = std::move(f);
+    assert(!f && g && h);
+    assert(g(2) == "int 2" && h(3) == "int 3");
+    assert(h.target<show>() && !h.target<int>());
+
+    // State is kept, copies are independent.
+    poly::function<int()> c = counter();
+    c();
+    auto d = c;
+    assert(c() == 2 && d() == 2 && c() == 3);
+
+    // Large function objects go to the heap but behave the same.
+    big b = {};
+    b.bytes[0] = 42;
+    poly::function<int()> e = b;
+    auto e2 = std::move(e);
+    assert(e2() == 42);
+
+    // A function object of exactly `buffer_size` bytes is stored inline.
+    typedef poly::function<std::ptrdiff_t()> summer;
+    static_assert(sizeof(full) == summer::buffer_size, "");
+    static_assert(summer::fits_inline<full>::value, "");
+    summer fl = full{1, 2, 3};
+    summer fl2 = fl;
+    summer fl3 = std::move(fl);
+    assert(fl2() == 6 && fl3() == 6);
+
+    // Move-only targets.
+    std::unique_ptr<int> p(new int(7));
+    auto owner = [](std::unique_ptr<int> & q) { return *q; };
+    poly::unique_function<int(std::unique_ptr<int> &)> u = owner;
+    assert(u(p) == 7);
+    static_assert(!std::is_copy_constructible<decltype(u)>::value, "");
+    struct holder {
+        std::unique_ptr<int> q;
+        int operator()() { return *q; }
+    };
+    poly::unique_function<int()> v = holder{std::move(p)};
+    poly::unique_function<int()> w = std::move(v);
+    assert(!v && w() == 7);
+    w = nullptr;
+    assert(!w);
+
+    // Only function objects callable as each signature convert, so overload
+    // sets of functions with different signatures work.
+    static_assert(!std::is_convertible<int, poly::function<void()>>::value, "");
+    static_assert(!std::is_convertible<show, summer>::value, "");
+    static_assert(!std::is_convertible<counter, shower>::value, "");
+    static_assert(std::is_convertible<counter, poly::function<void()>>::value,
+                  "");
+    struct overloads {
+        static int pick(poly::function<int(int)>) { return 1; }
+        static int pick(poly::function<int(std::string)>) { return 2; }
+    };
+    assert(overloads::pick([](int i) { return i; }) == 1);
+    assert(overloads::pick([](std::string s) { return int(s.size()); }) == 2);
+}
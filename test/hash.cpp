@@ -0,0 +1,55 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/hash.hpp>
+#include <cassert>
+#include <cctype>
+#include <string>
+#include <vector>
+
+struct key : poly::interface<key
+    , std::size_t(poly::hash_, poly::self const &)
+    , bool(poly::operator_eq_, poly::self const &, key const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(key); };
+
+struct point { int x, y; };
+
+namespace poly {
+template <> struct is_bitwise_comparable<point> : std::true_type {};
+} // poly
+
+// Has no padding, but its own equality and hash, which must be used.
+struct ci {
+    char c;
+    bool operator==(ci x) const {
+        return std::tolower(c) == std::tolower(x.c);
+    }
+};
+
+std::size_t call(poly::hash_, ci x) {
+    return std::hash<int>()(std::tolower(x.c));
+}
+
+int main() {
+    assert(poly::hash(123) == std::hash<int>()(123));
+    assert(poly::hash(std::string("abc")) == std::hash<std::string>()("abc"));
+    std::vector<int> v = {1, 2, 3};
+    assert(poly::hash(v) == poly::hash(std::vector<int>{1, 2, 3}));
+    assert(poly::hash(point{1, 2}) == poly::hash(point{1, 2}));
+
+    key a = 1, b = 1, c = 2, d = std::string("1");
+    key p = point{1, 2}, q = point{1, 2}, r = point{2, 1};
+    assert(poly::hash(a) == poly::hash(b));
+    assert(poly::operator_eq(a, b));
+    assert(!poly::operator_eq(a, c));
+    assert(!poly::operator_eq(a, d) && !poly::operator_eq(d, a));
+    assert(poly::operator_eq(p, q) && !poly::operator_eq(p, r));
+    assert(poly::hash(p) == poly::hash(q));
+
+    static_assert(!poly::is_bitwise_comparable<ci>::value, "");
+    key e = ci{'A'}, f = ci{'a'};
+    assert(poly::operator_eq(e, f));
+    assert(poly::hash(e) == poly::hash(f));
+}
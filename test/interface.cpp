@@ -4,7 +4,142 @@
 // file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
 #include <poly/interface.hpp>
+#include <cassert>
+#include <string>
+#include <utility>
+#include <vector>
+
+POLY_CALLABLE(f0); POLY_CALLABLE(f1); POLY_CALLABLE(f2); POLY_CALLABLE(f3);
+POLY_CALLABLE(f4); POLY_CALLABLE(f5); POLY_CALLABLE(f6); POLY_CALLABLE(f7);
+POLY_CALLABLE(f8); POLY_CALLABLE(f9); POLY_CALLABLE(f10); POLY_CALLABLE(f11);
+
+template <typename T> int call(f0_, T const &) { return 0; }
+template <typename T> int call(f1_, T const &) { return 1; }
+template <typename T> int call(f2_, T &) { return 2; }
+template <typename T> int call(f3_, T &, int i) { return 3 + i; }
+template <typename T> int call(f4_, T const &) { return 4; }
+template <typename T> int call(f5_, T const &) { return 5; }
+template <typename T> int call(f6_, T &) { return 6; }
+template <typename T> int call(f7_, T const &) { return 7; }
+template <typename T> int call(f8_, T const &) { return 8; }
+template <typename T> int call(f9_, T const &) { return 9; }
+template <typename T> int call(f10_, T const &) { return 10; }
+template <typename T> int call(f11_, T const &) { return 11; }
+
+typedef poly::interface<
+    int(f0_, poly::self const &), int(f1_, poly::self const &),
+    int(f2_, poly::self &), int(f3_, poly::self &, int),
+    int(f4_, poly::self const &), int(f5_, poly::self const &),
+    int(f6_, poly::self &), int(f7_, poly::self const &),
+    int(f8_, poly::self const &), int(f9_, poly::self const &),
+    int(f10_, poly::self const &), int(f11_, poly::self const &)> wide;
+
+typedef poly::interface<int(f0_, poly::self const &)> narrow;
+
+// A model is its payload plus one vtable pointer, however many signatures the
+// interface has.
+template <typename I, typename T>
+struct expected_size {
+    struct layout { void * vptr; T x; };
+    static constexpr bool value =
+        sizeof(typename I::template model<T>) == sizeof(layout);
+};
+
+struct one_byte { char c; };
+struct pair { double a, b; };
+
+static_assert(expected_size<wide, char>::value, "");
+static_assert(expected_size<wide, int>::value, "");
+static_assert(expected_size<wide, pair>::value, "");
+static_assert(expected_size<wide, one_byte>::value, "");
+static_assert(expected_size<narrow, int>::value, "");
+static_assert(sizeof(wide::model<int>) == sizeof(narrow::model<int>), "");
+static_assert(sizeof(wide::model<char>) == 2 * sizeof(void *), "");
+
+static_assert(poly::interface<>::fits_inline<std::string>::value, "");
+static_assert(poly::interface<>::fits_inline<double>::value, "");
+static_assert(!poly::interface<>::fits_inline<std::vector<char>[2]>::value,
+              "");
+static_assert(std::is_nothrow_move_constructible<poly::interface<>>::value,
+              "");
+
+struct big { char bytes[100]; };
+
+void test_any() {
+    poly::interface<> e;
+    assert(!e.valid() && !e.data());
+#ifndef POLY_NO_RTTI
+    assert(e.type() == typeid(void));
+#endif
+
+    poly::interface<> x = 1.5;
+    assert(x.is_local() && x.holds<double>());
+#ifndef POLY_NO_RTTI
+    assert(x.type() == typeid(double));
+#endif
+    assert(poly::cast<double>(x) == 1.5);
+    assert(!poly::cast<int>(&x) && poly::cast<double>(&x));
+#ifndef POLY_NO_EXCEPTIONS
+    bool thrown = false;
+    try {
+        poly::cast<int>(x);
+    } catch (poly::bad_cast &) {
+        thrown = true;
+    }
+    assert(thrown);
+#endif
+
+    // Assigning a value of the held type assigns in place.
+    void * held = x.data();
+    x = 2.5;
+    assert(x.data() == held && poly::cast<double>(x) == 2.5);
+
+    poly::interface<> s = std::string(100, 'a');
+    poly::interface<> t = s;
+    assert(poly::cast<std::string>(t) == poly::cast<std::string>(s));
+    assert(t.data() != s.data());
+    poly::interface<> u = std::move(s);
+    assert(!s.valid() && poly::cast<std::string>(u).size() == 100);
+
+    big b = {{'x'}};
+    poly::interface<> r = b;
+    assert(!r.is_local() && poly::cast<big>(r).bytes[0] == 'x');
+    poly::interface<> r2 = r;
+    assert(poly::cast<big>(r2).bytes[0] == 'x' && r2.data() != r.data());
+
+    swap(x, r);
+    assert(poly::cast<big>(x).bytes[0] == 'x' && poly::cast<double>(r) == 2.5);
+
+    std::vector<int> & v = x.emplace<std::vector<int>>(3, 7);
+    assert(v.size() == 3 && poly::cast<std::vector<int>>(x)[2] == 7);
+    x.reset();
+    assert(!x.valid());
+
+    // Assigning a part of the held value replaces the value with the part.
+    poly::interface<> ws = std::vector<std::string>{std::string(50, 'w')};
+    ws = poly::cast<std::vector<std::string>>(ws)[0];
+    assert(poly::cast<std::string>(ws) == std::string(50, 'w'));
+
+    // Values which cannot be assigned to are replaced.
+    int k = 3;
+    auto l = [k] { return k; };
+    ws = l;
+    ws = l;
+    assert(poly::cast<decltype(l)>(ws)() == 3);
+
+    poly::interface<> const c = 'c';
+    assert(poly::cast<char>(c) == 'c' && *poly::cast<char>(&c) == 'c');
+}
 
 int main() {
-    
+    wide w = 1;
+    assert(f0(w) == 0 && f1(w) == 1 && f2(w) == 2 && f3(w, 1) == 4);
+    assert(f4(w) == 4 && f5(w) == 5 && f6(w) == 6 && f7(w) == 7);
+    assert(f8(w) == 8 && f9(w) == 9 && f10(w) == 10 && f11(w) == 11);
+
+    wide const & c = w;
+    assert(f11(c) == 11);
+    assert(poly::cast<int>(w) == 1);
+
+    test_any();
 }
@@ -0,0 +1,94 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/interface_cast.hpp>
+#include "count_allocations.hpp"
+#include <cassert>
+#include <string>
+
+POLY_CALLABLE(draw);
+POLY_CALLABLE(serialize);
+POLY_CALLABLE(describe);
+
+struct drawable : poly::interface<drawable
+    , void(draw_, poly::self const &, std::string &)
+    > { POLY_INTERFACE_CONSTRUCTORS(drawable); };
+
+struct serializable : poly::interface<serializable
+    , void(serialize_, poly::self const &, std::string &)
+    > { POLY_INTERFACE_CONSTRUCTORS(serializable); };
+
+struct describable : poly::interface<describable
+    , char const *(describe_, poly::self const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(describable); };
+
+struct circle { int r; };
+struct square { int side; };
+struct label { char const * text; };
+
+void call(draw_, circle const &, std::string & out) { out += "O"; }
+void call(draw_, square const &, std::string & out) { out += "[]"; }
+void call(draw_, label const & l, std::string & out) { out += l.text; }
+
+void call(serialize_, circle const & c, std::string & out) {
+    out += "circle " + std::to_string(c.r);
+}
+void call(serialize_, label const & l, std::string & out) {
+    out += "label ";
+    out += l.text;
+}
+
+char const * call(describe_, circle const &) { return "a circle"; }
+
+namespace poly {
+template <> struct capabilities<circle>
+    : implements<serializable, describable> {};
+template <> struct capabilities<label> : implements<serializable> {};
+} // poly
+
+int main() {
+    drawable shapes[] = {circle{2}, square{3}, label{"hi"}};
+
+    std::string out;
+    std::size_t before = allocations;
+    poly::constant_ref<serializable> s0 =
+        poly::interface_cast<serializable>(shapes[0]);
+    poly::constant_ref<serializable> s1 =
+        poly::interface_cast<serializable>(shapes[1]);
+    poly::constant_ref<describable> d0 =
+        poly::interface_cast<describable>(shapes[0]);
+    poly::constant_ref<describable> d2 =
+        poly::interface_cast<describable>(shapes[2]);
+    assert(allocations == before);
+
+    assert(s0 && !s1 && d0 && !d2);
+    assert(s0.target<circle>() == poly::cast<circle>(&shapes[0]));
+    out.reserve(64);
+    before = allocations;
+    serialize(s0, out);
+    assert(allocations == before);
+    assert(out == "circle 2");
+    assert(std::string(describe(d0)) == "a circle");
+
+    out.clear();
+    for (auto const & x : shapes) {
+        draw(x, out);
+        if (auto s = poly::interface_cast<serializable>(x)) {
+            out += "(";
+            serialize(s, out);
+            out += ")";
+        }
+    }
+    assert(out == "O(circle 2)[]hi(label hi)");
+
+    // Capabilities belong to the held type, whichever interface holds it.
+    poly::interface<> any = label{"x"};
+    out.clear();
+    serialize(poly::interface_cast<serializable>(any), out);
+    assert(out == "label x");
+    assert(!poly::interface_cast<describable>(any));
+    assert(!poly::interface_cast<serializable>(poly::interface<>()));
+    assert(!poly::interface_cast<serializable>(drawable()));
+}
@@ -0,0 +1,51 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/intern.hpp>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+struct leaf : poly::interface<leaf
+    , std::size_t(poly::hash_, poly::self const &)
+    , bool(poly::operator_eq_, poly::self const &, leaf const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(leaf); };
+
+int main() {
+    poly::intern_table<leaf> table;
+
+    poly::interned<leaf> a(std::string("abc"), table);
+    poly::interned<leaf> b(std::string("abc"), table);
+    poly::interned<leaf> c(std::vector<int>{1, 2}, table);
+    poly::interned<leaf> d(123, table);
+    assert(a == b && &a.get() == &b.get());
+    assert(a != c && a != d);
+    assert(a.use_count() == 2);
+    assert(poly::hash(a) == poly::hash(a.get()));
+    assert(poly::cast<std::string>(a.get()) == "abc");
+
+    std::unordered_set<poly::interned<leaf>> set = {a, b, c, d};
+    assert(set.size() == 3);
+
+    // Many threads interning overlapping values agree on the instances.
+    std::vector<std::vector<poly::interned<leaf>>> results(4);
+    std::vector<std::thread> threads;
+    for (std::size_t t = 0; t < results.size(); ++t) {
+        threads.emplace_back([&table, &results, t] {
+            for (int i = 0; i < 1000; ++i)
+                results[t].emplace_back(leaf(i % 100), table);
+        });
+    }
+    for (auto & t : threads) t.join();
+    for (auto & r : results)
+        for (int i = 0; i < 1000; ++i) assert(r[i] == results[0][i % 100]);
+
+    // Dead instances are reclaimed.
+    results.clear();
+    for (int i = 0; i < 10000; ++i) poly::interned<leaf>(i, table);
+    assert(table.size() < 10000);
+}
@@ -0,0 +1,60 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/lazy.hpp>
+#include "count_allocations.hpp"
+#include <cassert>
+
+struct number : poly::interface<number
+    , number(poly::operator_add_, poly::self const &, number const &)
+    , number(poly::operator_sub_, poly::self const &, number const &)
+    , number(poly::operator_mul_, poly::self const &, number const &)
+    , number(poly::operator_sub_, poly::self const &)
+    >
+{ POLY_INTERFACE_CONSTRUCTORS(number); };
+
+int main() {
+    using poly::lazy;
+    using poly::operator_add;
+    using poly::operator_mul;
+    using poly::operator_sub;
+
+    number a = 2, b = 3, c = 4;
+
+    // Building an expression does not call anything.
+    std::size_t before = allocations;
+    auto e = operator_add(operator_mul(lazy(a), b), operator_sub(lazy(c)));
+    assert(allocations == before);
+
+    // Fused: one dispatch on `int`, one allocation for the result.
+    number r = poly::evaluate<double, int>(e);
+    assert(allocations == before + 1);
+    assert(poly::cast<int>(r) == 2);
+
+    // Evaluating into an interface holding an `int` reuses its model.
+    poly::evaluate<int>(r, operator_sub(operator_mul(lazy(r), r), a));
+    assert(allocations == before + 1);
+    assert(poly::cast<int>(r) == 2);
+
+    // Not among the listed types: node by node.
+    number x = 1.5, y = 2.0;
+    auto f = operator_mul(lazy(x), operator_add(lazy(y), y));
+    number s = poly::evaluate<int>(f);
+    assert(poly::cast<double>(s) == 6.0);
+    number t = poly::evaluate<>(f);
+    assert(poly::cast<double>(t) == 6.0);
+    assert(poly::cast<double>(poly::evaluate<int, double>(f)) == 6.0);
+
+    // Mixed leaf types fall back too, and fail there like the signatures do.
+#ifndef POLY_NO_EXCEPTIONS
+    bool thrown = false;
+    try {
+        poly::evaluate<int, double>(operator_add(lazy(a), x));
+    } catch (poly::bad_cast &) {
+        thrown = true;
+    }
+    assert(thrown);
+#endif
+}
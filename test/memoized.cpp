@@ -0,0 +1,117 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/memoized.hpp>
+#include <atomic>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ns {
+
+POLY_CALLABLE(measure);
+POLY_CALLABLE(fib);
+
+struct key : poly::interface<key
+    , std::size_t(poly::hash_, poly::self const &)
+    , bool(poly::operator_eq_, poly::self const &, key const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(key); };
+
+struct point { int x, y; };
+
+std::atomic<int> calls(0);
+
+std::size_t call(measure_, std::string const & s) { ++calls; return s.size(); }
+std::size_t call(measure_, int n) { ++calls; return 2 * n; }
+std::size_t call(measure_, point p) { ++calls; return p.x * p.y; }
+std::size_t call(measure_, char const * s) { ++calls; return s[0]; }
+std::size_t call(measure_, key const & k) { ++calls; return poly::hash(k); }
+
+std::size_t call(measure_, std::string const & s, int n) {
+    ++calls;
+    return s.size() + n;
+}
+
+static poly::memoized<fib_> const memo_fib;
+
+unsigned long long call(fib_, int n) {
+    ++calls;
+    return n < 2 ? n : memo_fib(n - 1) + memo_fib(n - 2);
+}
+
+} // ns
+
+namespace poly {
+template <> struct is_bitwise_comparable<ns::point> : std::true_type {};
+} // poly
+
+int main() {
+    using ns::calls;
+
+    poly::memoized<ns::measure_> measure(64);
+    assert(measure.capacity() == 64);
+    assert(measure(std::string("abc")) == 3 && calls == 1);
+    assert(measure(std::string("abc")) == 3 && calls == 1);
+    assert(measure(3) == 6 && calls == 2);
+    assert(measure(3) == 6 && calls == 2);
+    assert(measure(std::string("abc"), 3) == 6 && calls == 3);
+    assert(measure(std::string("abc"), 4) == 7 && calls == 4);
+    assert(measure(ns::point{2, 3}) == 6 && calls == 5);
+    assert(measure(ns::point{2, 3}) == 6 && calls == 5);
+    char const * hello = "hello";
+    assert(measure(hello) == 'h' && calls == 6);
+    assert(measure(hello) == 'h' && calls == 6);
+
+    // Interfaces are keyed by the type and value they hold.
+    ns::key a = 1, b = 1, c = std::string("1");
+    std::size_t const ha = measure(a);
+    assert(calls == 7 && measure(b) == ha && calls == 7);
+    measure(c);
+    assert(calls == 8);
+
+    poly::memoized_stats s = measure.stats();
+    assert(s.hits == 5 && s.misses == 8 && s.evictions == 0 && s.size == 8);
+
+    // Beyond the capacity, results are evicted.
+    calls = 0;
+    for (int i = 0; i < 1000; ++i) assert(measure(i) == std::size_t(2 * i));
+    s = measure.stats();
+    assert(calls == 999 && s.size == 64 && s.evictions == 8 + 999 - 64);
+
+    // Recently used results survive the sweep.
+    calls = 0;
+    for (int i = 0; i < 10000; ++i) {
+        measure(-1);
+        measure(i + 1000);
+    }
+    assert(calls == 10001);
+
+    measure.clear();
+    assert(measure.stats().size == 0);
+    calls = 0;
+    measure(-1);
+    assert(calls == 1);
+
+    // Recursive calls are fine.
+    calls = 0;
+    assert(ns::memo_fib(90) == 2880067194370816120ull && calls == 91);
+    assert(ns::memo_fib(80) == 23416728348467685ull && calls == 91);
+
+    // So are concurrent ones.
+    poly::memoized<ns::measure_> shared;
+    calls = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&shared] {
+            for (int i = 0; i < 10000; ++i)
+                assert(shared(i % 500) == std::size_t(2 * (i % 500)));
+        });
+    }
+    for (auto & t : threads) t.join();
+    s = shared.stats();
+    assert(s.size == 500 && s.evictions == 0);
+    assert(s.hits + s.misses == 40000 && int(s.misses) == calls);
+}
@@ -0,0 +1,90 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// The payload copies made by the rvalue paths of interfaces. The expected
+// counts are the same on every compiler, with or without
+// `POLY_NO_REF_QUALIFIERS`.
+
+#include <poly/interface.hpp>
+#include <cassert>
+#include <string>
+#include <utility>
+
+namespace ns {
+
+POLY_CALLABLE(take);
+POLY_CALLABLE(steal);
+POLY_CALLABLE(append);
+POLY_CALLABLE(peek);
+
+// Counts its copies; moves are free.
+struct payload {
+    static int copies;
+    payload() : s(1000, 'x') {}
+    payload(payload const & x) : s(x.s) { ++copies; }
+    payload(payload &&) = default;
+    payload & operator=(payload const & x) { s = x.s; ++copies; return *this; }
+    payload & operator=(payload &&) = default;
+    std::string s;
+};
+int payload::copies = 0;
+
+struct doc : poly::interface<doc
+    , std::string(take_, poly::self)
+    , std::string(steal_, poly::self &&)
+    , doc(append_, poly::self, char)
+    , std::size_t(peek_, poly::self const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(doc); };
+
+std::string call(take_, payload && p) { return std::move(p.s); }
+std::string call(steal_, payload && p) { return std::move(p.s); }
+payload call(append_, payload && p, char c) {
+    p.s += c;
+    return std::move(p);
+}
+std::size_t call(peek_, payload const & p) { return p.s.size(); }
+
+} // ns
+
+int main() {
+    using ns::doc;
+    using ns::payload;
+    int & copies = payload::copies;
+
+    // Constructing and moving interfaces.
+    doc d = payload();
+    doc e = std::move(d);
+    assert(copies == 0);
+    doc f = e;
+    assert(copies == 1);
+    copies = 0;
+
+    // Consuming signatures move out of the model.
+    assert(ns::take(std::move(e)).size() == 1000);
+    assert(ns::steal(std::move(f)).size() == 1000);
+    assert(copies == 0);
+
+    // Unless given an lvalue to `self`, which is copied first.
+    doc g = payload();
+    assert(ns::take(g).size() == 1000);
+    assert(ns::peek(g) == 1000);
+    assert(copies == 1);
+    copies = 0;
+
+    // Returning the interface type reuses the model.
+    doc h = ns::append(ns::append(std::move(g), 'a'), 'b');
+    assert(ns::peek(h) == 1002);
+    assert(copies == 0);
+
+    // Moving the held value out.
+    payload p = std::move(h).move<payload>();
+    assert(p.s.size() == 1002);
+#ifndef POLY_NO_REF_QUALIFIERS
+    doc i = payload();
+    payload q = std::move(i).get<payload>();
+    assert(q.s.size() == 1000);
+#endif
+    assert(copies == 0);
+}
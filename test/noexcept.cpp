@@ -0,0 +1,83 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/constant.hpp>
+#include <poly/interface.hpp>
+#include <cassert>
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#ifdef __cpp_noexcept_function_type
+
+POLY_CALLABLE(hash);
+POLY_CALLABLE(reset);
+POLY_CALLABLE(name);
+
+struct key : poly::interface<key
+    , std::size_t(hash_, poly::self const &) noexcept
+    , void(reset_, poly::self &) noexcept
+    , std::string(name_, poly::self const &)
+    >
+{ POLY_INTERFACE_CONSTRUCTORS(key); };
+
+struct id { std::size_t n; };
+
+std::size_t call(hash_, id const & x) noexcept { return x.n; }
+void call(reset_, id & x) noexcept { x.n = 0; }
+std::string call(name_, id const &) { return "id"; }
+
+std::size_t call(hash_, std::string const & s) noexcept { return s.size(); }
+void call(reset_, std::string & s) noexcept { s.clear(); }
+std::string call(name_, std::string const & s) { return s; }
+
+// The signatures keep their exception specifications, in the friend `call`s
+// as well as in the virtual functions of the models.
+static_assert(noexcept(hash(std::declval<key const &>())), "");
+static_assert(noexcept(reset(std::declval<key &>())), "");
+static_assert(!noexcept(name(std::declval<key const &>())), "");
+static_assert(noexcept(std::declval<key::concept_type const &>()(
+                  hash_(), poly::self())), "");
+
+// No exception can escape `hash`, so the caller needs no cleanup path for
+// `s`, whereas `name` may throw. Checked by test/noexcept.sh.
+std::size_t hash_twice(key const & k) {
+    std::string s = "xyz";
+    return hash(k) + call(hash_(), s);
+}
+
+std::size_t name_twice(key const & k) {
+    std::string s = "xyz";
+    return name(k).size() + s.size();
+}
+
+constexpr id seven{7};
+constexpr poly::constant_ref<key> constant_key = seven;
+static_assert(noexcept(hash(constant_key)), "");
+
+int main() {
+    key a = id{42};
+    key b = std::string("hello");
+    assert(hash(a) == 42);
+    assert(hash(b) == 5);
+    assert(hash_twice(a) == 45);
+    assert(name_twice(a) == 5);
+    assert(name(b) == "hello");
+    reset(a);
+    reset(b);
+    assert(hash(a) == 0);
+    assert(hash(b) == 0);
+    assert(hash(constant_key) == 7);
+
+    poly::interface<std::size_t(hash_, poly::self const &) noexcept> c = a;
+    static_assert(noexcept(hash(c)), "");
+    assert(hash(c) == 0);
+}
+
+#else
+
+int main() {}
+
+#endif
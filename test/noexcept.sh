@@ -0,0 +1,43 @@
+#!/bin/sh
+# Copyright 2012 Pyry Jahkola.
+#
+# Distributed under the Boost Software License, Version 1.0. (See accompanying
+# file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+# Codegen check for test/noexcept.cpp: calling through a noexcept signature
+# leaves no landing pad in the caller. Compiles the test to assembly and
+# looks for the exception table reference (`.cfi_lsda`) of `hash_twice`,
+# which must have none, and of `name_twice`, which calls a signature that may
+# throw and must have one. Run from anywhere; `CXX` and `CXXFLAGS` select the
+# build.
+
+set -e
+cd "$(dirname "$0")/.."
+CXX=${CXX:-c++}
+CXXFLAGS=${CXXFLAGS:--O2}
+out=${TMPDIR:-/tmp}/poly_noexcept.$$.s
+trap 'rm -f "$out"' EXIT
+
+$CXX -std=c++17 $CXXFLAGS -Iinclude -S test/noexcept.cpp -o "$out"
+
+# The number of landing pad markers in the body of the function `$1`.
+pads() {
+    awk -v f="$1:" '
+        $1 == f { p = 1 }
+        p && /\.cfi_lsda|_Unwind_Resume|__cxa_end_cleanup/ { n++ }
+        p && /\.cfi_endproc/ { exit }
+        END { print n + 0 }
+    ' "$out"
+}
+
+hash_pads=$(pads _Z10hash_twiceRK3key)
+name_pads=$(pads _Z10name_twiceRK3key)
+echo "landing pads: hash_twice $hash_pads, name_twice $name_pads"
+if [ "$hash_pads" != 0 ]; then
+    echo "FAIL: hash_twice has a landing pad" >&2
+    exit 1
+fi
+if [ "$name_pads" = 0 ]; then
+    echo "FAIL: no landing pad found in name_twice" >&2
+    exit 1
+fi
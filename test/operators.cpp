@@ -5,6 +5,8 @@
 
 #include <poly/operators.hpp>
 #include <poly/interface.hpp>
+#include "count_allocations.hpp"
+#include <cassert>
 #include <iostream>
 
 // POLY_CALLABLE(add);
@@ -29,10 +31,58 @@ template <typename T>
 
 } // poly
 
+struct number : poly::interface<number
+    , number(poly::operator_add_, poly::self, number const &)
+    , number(poly::operator_mul_, poly::self const &, number const &)
+    , void(poly::operator_iadd_, poly::self &, number const &)
+    , void(poly::operator_imul_, poly::self &, number const &)
+    >
+{ POLY_INTERFACE_CONSTRUCTORS(number); };
+
 int main() {
     addable a = 1;
     addable b = a;
     //addable c = a + b; // doesn't work yet...
     std::cout << poly::operator_add(1, 2) << std::endl;
     std::cout << poly::cast<int>(poly::operator_add(a, b)) << std::endl;
+
+    // Compound assignment mutates the held value in place.
+    number sum = 0, x = 2;
+    void const * held = sum.data();
+    std::size_t before = allocations;
+    for (int i = 0; i < 100; ++i) poly::operator_iadd(sum, x);
+    poly::operator_imul(sum, x);
+    assert(allocations == before);
+    assert(sum.data() == held && poly::cast<int>(sum) == 400);
+
+    // Consuming `self` reuses its model for the result.
+    for (int i = 0; i < 100; ++i) sum = poly::operator_add(std::move(sum), x);
+    assert(allocations == before);
+    assert(sum.data() == held && poly::cast<int>(sum) == 600);
+
+    // Otherwise, the result is a new model.
+    number product = poly::operator_mul(sum, x);
+    assert(allocations == before + 1);
+    assert(poly::cast<int>(product) == 1200 && poly::cast<int>(sum) == 600);
+
+    // Assigning a value of the held type reuses the model too.
+    sum = 7;
+    assert(allocations == before + 1);
+    assert(sum.data() == held && poly::cast<int>(sum) == 7);
+    sum = 7.5;
+    assert(allocations == before + 2);
+    assert(poly::cast<double>(sum) == 7.5);
+
+    // Mixed types are rejected.
+#ifndef POLY_NO_EXCEPTIONS
+    bool thrown = false;
+    try {
+        poly::operator_iadd(sum, x);
+    } catch (poly::bad_cast &) {
+        thrown = true;
+    }
+    assert(thrown);
+#endif
+    poly::operator_imul(sum, number(2.0));
+    assert(poly::cast<double>(sum) == 15.0);
 }
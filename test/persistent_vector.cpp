@@ -0,0 +1,75 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/persistent_vector.hpp>
+#include <poly/interface.hpp>
+#include <cassert>
+#include <string>
+
+POLY_CALLABLE(size);
+
+template <typename T> std::size_t call(size_, T const &) { return 1; }
+
+template <typename T>
+std::size_t call(size_, poly::persistent_vector<T> const & xs) {
+    std::size_t n = 0;
+    for (auto & x : xs) n += size(x);
+    return n;
+}
+
+using sized = poly::interface<std::size_t(size_, poly::self const &)>;
+
+int main() {
+    std::size_t const n = 40000;
+
+    poly::persistent_vector<int> xs;
+    for (std::size_t i = 0; i < n; ++i) xs.push_back(int(i));
+    assert(xs.size() == n);
+    for (std::size_t i = 0; i < n; ++i) assert(xs[i] == int(i));
+
+    // Copies share everything until modified.
+    auto ys = xs;
+    assert(identical(xs, ys));
+    ys.set(12345, -1);
+    ys.push_back(-2);
+    assert(!identical(xs, ys));
+    assert(xs[12345] == 12345 && ys[12345] == -1);
+    assert(xs.size() == n && ys.size() == n + 1);
+
+    // Iteration, including crossing leaves and the tail.
+    int expected = 0;
+    for (auto x : xs) assert(x == expected++);
+    assert(std::size_t(ys.end() - ys.begin()) == ys.size());
+
+    // Popping all the way down leaves the snapshot alone.
+    auto zs = xs;
+    for (std::size_t i = n; i-- > 0;) {
+        assert(zs.back() == int(i));
+        zs.pop_back();
+        assert(zs.size() == i);
+    }
+    assert(zs.empty());
+    assert(xs[n - 1] == int(n - 1));
+    for (std::size_t i = 0; i < 100; ++i) zs.push_back(int(i));
+    assert(zs[99] == 99);
+
+    // Moved-from vectors are empty, and usable again.
+    auto ws = std::move(zs);
+    assert(zs.empty() && ws.size() == 100 && ws[99] == 99);
+    for (int i = 0; i < 5; ++i) zs.push_back(i);
+    ws = std::move(zs);
+    assert(zs.empty() && ws.size() == 5 && ws[4] == 4);
+    zs.push_back(7);
+    zs.push_back(8);
+    assert(zs.size() == 2 && zs[0] == 7 && zs[1] == 8);
+
+    // Nested documents of interfaces.
+    poly::persistent_vector<sized> doc = {sized(1), sized(std::string("a"))};
+    doc.push_back(doc);
+    doc.push_back(doc);
+    assert(size(doc) == 2 + 2 + 4);
+    sized whole = doc;
+    assert(size(whole) == 8);
+}
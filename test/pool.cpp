@@ -0,0 +1,91 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/pool.hpp>
+#include <poly/interface.hpp>
+#include <cassert>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct small { int a, b; };
+struct large { char bytes[1000]; };
+struct alignas(32) aligned {
+    explicit aligned(int x) : x(x) {}
+    int x;
+};
+
+namespace poly {
+template <> struct is_pooled<small> : std::true_type {};
+template <> struct is_pooled<large> : std::true_type {};
+template <> struct is_pooled<aligned> : std::true_type {};
+template <> struct is_pooled<std::string> : std::true_type {};
+} // poly
+
+POLY_CALLABLE(sum);
+
+int call(sum_, small const & s) { return s.a + s.b; }
+int call(sum_, large const & l) { return l.bytes[0]; }
+int call(sum_, aligned const & a) { return a.x; }
+int call(sum_, std::string const & s) { return int(s.size()); }
+int call(sum_, int i) { return i; }
+
+typedef poly::interface<int(sum_, poly::self const &)> summable;
+
+int main() {
+    // Freed blocks are reused by the same thread.
+    void const * first;
+    {
+        summable a = small{1, 2};
+        assert(sum(a) == 3);
+        first = a.data();
+    }
+    {
+        summable b = small{3, 4};
+        assert(b.data() == first);
+        assert(sum(b) == 7);
+    }
+
+    // Copies are pooled too; oversized, over-aligned and unpooled types work.
+    {
+        summable a = std::string("hello");
+        summable b = a;
+        assert(sum(b) == 5 && a.data() != b.data());
+        large l = {};
+        l.bytes[0] = 9;
+        summable c = l;
+        assert(sum(c) == 9);
+        summable d = summable::make<aligned>(5);
+        assert(sum(d) == 5);
+#ifdef __cpp_aligned_new
+        assert(reinterpret_cast<std::size_t>(d.data()) % 32 == 0);
+#endif
+        summable e = 6;
+        assert(sum(e) == 6);
+    }
+
+    // Create on one thread, destroy on another, and allocate again.
+    std::vector<summable> xs;
+    std::thread producer([&] {
+        for (int i = 0; i < 10000; ++i) xs.push_back(small{i, 1});
+    });
+    producer.join();
+    std::thread consumer([&] {
+        for (int i = 0; i < 10000; ++i) assert(sum(xs[i]) == i + 1);
+        xs.clear();
+    });
+    consumer.join();
+    for (int i = 0; i < 10000; ++i) xs.push_back(small{i, 2});
+    for (int i = 0; i < 10000; ++i) assert(sum(xs[i]) == i + 2);
+
+    // Raw use of the pool.
+    void * p = poly::pool_allocate(24);
+    void * q = poly::pool_allocate(24);
+    assert(p != q);
+    poly::pool_deallocate(q, 24);
+    poly::pool_deallocate(p, 24);
+    assert(poly::pool_allocate(24) == p);
+    poly::pool_deallocate(p, 24);
+}
@@ -0,0 +1,123 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/relocate.hpp>
+#include <poly/interface.hpp>
+#include "count_allocations.hpp"
+#include <cassert>
+#include <string>
+#include <vector>
+
+POLY_CALLABLE(key);
+
+int call(key_, int i) { return i; }
+int call(key_, std::string const & s) { return int(s.size()); }
+
+struct keyed : poly::interface<keyed, int(key_, poly::self const &)>
+{ POLY_INTERFACE_CONSTRUCTORS(keyed); };
+
+using plain = poly::interface<int(key_, poly::self const &)>;
+
+// Not default constructible.
+struct id {
+    explicit id(int n) : n(n) {}
+    int n;
+};
+
+// Adds a member to the interface, so it is not relocatable bytewise.
+struct labelled : poly::interface<labelled, int(key_, poly::self const &)> {
+    POLY_INTERFACE_CONSTRUCTORS(labelled);
+    std::string label;
+};
+
+static_assert(poly::is_trivially_relocatable<keyed>::value, "");
+static_assert(!poly::is_trivially_relocatable<labelled>::value, "");
+static_assert(poly::is_trivially_relocatable<plain>::value, "");
+static_assert(poly::is_trivially_relocatable<int>::value, "");
+
+template <typename T>
+std::vector<int> keys(std::vector<T> const & v) {
+    std::vector<int> r;
+    for (auto & x : v) r.push_back(key(x));
+    return r;
+}
+
+int main() {
+    std::vector<keyed> v;
+    for (int i = 0; i < 5; ++i) v.push_back(i);
+    poly::insert(v, v.begin() + 2, keyed(std::string("abcdefg")));
+    assert((keys(v) == std::vector<int>{0, 1, 7, 2, 3, 4}));
+    poly::erase(v, v.begin() + 1, v.begin() + 3);
+    assert((keys(v) == std::vector<int>{0, 2, 3, 4}));
+    poly::erase(v, v.begin());
+    poly::insert(v, v.end(), keyed(1));
+    assert((keys(v) == std::vector<int>{2, 3, 4, 1}));
+
+    // Inserting at the front, and erasing, shift the tail in place.
+    v.reserve(v.size() + 1);
+    keyed nine = 9;
+    std::size_t const before = allocations;
+    poly::insert(v, v.begin(), std::move(nine));
+    assert(allocations == before);
+    assert((keys(v) == std::vector<int>{9, 2, 3, 4, 1}));
+    std::size_t const erasing = allocations;
+    poly::erase(v, v.begin() + 1, v.begin() + 3);
+    assert(allocations == erasing);
+    assert((keys(v) == std::vector<int>{9, 4, 1}));
+
+    std::vector<id> ids;
+    for (int i = 0; i < 4; ++i) poly::insert(ids, ids.begin(), id(i));
+    poly::erase(ids, ids.begin() + 1, ids.begin() + 3);
+    assert(ids.size() == 2 && ids[0].n == 3 && ids[1].n == 0);
+
+    std::vector<keyed> w;
+    for (int i = 0; i < 1000; ++i) {
+        if (i % 3) w.push_back((i * 7919) % 1000);
+        else w.push_back(std::string(std::size_t((i * 7919) % 1000), 'x'));
+    }
+    poly::sort(w, [](keyed const & a, keyed const & b) noexcept {
+        return key(a) < key(b);
+    });
+    for (std::size_t i = 1; i < w.size(); ++i)
+        assert(key(w[i - 1]) <= key(w[i]));
+
+    // Raw relocation between uninitialized buffers.
+    std::allocator<keyed> alloc;
+    std::size_t n = w.size();
+    keyed * a = alloc.allocate(n);
+    keyed * b = alloc.allocate(n);
+    std::uninitialized_copy(w.begin(), w.end(), a);
+    assert(poly::relocate(a, a + n, b) == b + n);
+    assert(key(b[0]) == 0 && key(b[999]) == 999);
+    for (std::size_t i = 0; i < n; ++i) b[i].~keyed();
+    alloc.deallocate(a, n);
+    alloc.deallocate(b, n);
+
+    // A comparator which may throw sorts the usual way.
+    std::vector<keyed> t = {keyed(3), keyed(std::string("a")), keyed(2)};
+    poly::sort(t, [](keyed const & a, keyed const & b) {
+        return key(a) < key(b);
+    });
+    assert((keys(t) == std::vector<int>{1, 2, 3}));
+
+    // Not trivially relocatable: falls back to the member functions.
+    std::vector<labelled> ls;
+    for (int i = 0; i < 40; ++i) {
+        ls.push_back(labelled(i));
+        ls.back().label = std::string(std::size_t(i), 'x');
+    }
+    poly::insert(ls, ls.begin(), labelled(-1));
+    poly::erase(ls, ls.begin() + 1, ls.begin() + 3);
+    assert(ls.size() == 39 && key(ls[0]) == -1 && key(ls[1]) == 2);
+    for (std::size_t i = 1; i < ls.size(); ++i)
+        assert(ls[i].label == std::string(i + 1, 'x'));
+
+    std::vector<std::string> s = {"a", "c"};
+    poly::insert(s, s.begin() + 1, std::string("b"));
+    poly::sort(s, std::greater<std::string>());
+    assert((s == std::vector<std::string>{"c", "b", "a"}));
+    poly::erase(s, s.begin());
+    assert((s == std::vector<std::string>{"b", "a"}));
+}
@@ -0,0 +1,92 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/scheduler.hpp>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <memory>
+#include <vector>
+
+// Sums the leaves of a binary tree of tasks of depth `n`.
+void tree(poly::scheduler & s, int n, std::atomic<long> & leaves) {
+    if (n == 0) {
+        ++leaves;
+        return;
+    }
+    s.spawn([&s, n, &leaves] { tree(s, n - 1, leaves); });
+    s.spawn([&s, n, &leaves] { tree(s, n - 1, leaves); });
+}
+
+// fib(n) by continuations: each spawns its halves, then adds their results.
+void fib(poly::scheduler & s, int n, long & out) {
+    if (n < 2) {
+        out = n;
+        return;
+    }
+    std::shared_ptr<std::array<long, 2>> r(new std::array<long, 2>());
+    s.spawn([&s, n, r] {
+        fib(s, n - 1, (*r)[0]);
+        fib(s, n - 2, (*r)[1]);
+    }, [r, &out] { out = (*r)[0] + (*r)[1]; });
+}
+
+struct add_owned {
+    std::unique_ptr<int> p;
+    std::atomic<int> * n;
+    void operator()() { *n += *p; }
+};
+
+int main() {
+    std::atomic<int> n(0);
+    {
+        poly::scheduler s(3);
+        assert(s.size() == 3);
+        for (int i = 0; i < 10000; ++i) s.spawn([&n] { ++n; });
+        s.wait();
+        assert(n == 10000);
+
+        // Spawned from tasks, to the deques of the workers, overflowing them.
+        std::atomic<long> leaves(0);
+        s.spawn([&] { tree(s, 14, leaves); });
+        s.spawn([&] {
+            for (int i = 0; i < 3 * int(poly::scheduler_deque_size); ++i)
+                s.spawn([&leaves] { ++leaves; });
+        });
+        s.wait();
+        assert(leaves == (1 << 14) + 3 * long(poly::scheduler_deque_size));
+
+        // Continuations run once all the tasks below them have.
+        long f = 0;
+        s.spawn([&] { fib(s, 20, f); });
+        s.wait();
+        assert(f == 6765);
+
+        std::atomic<int> children(0);
+        int seen = -1;
+        s.spawn([&] {
+            for (int i = 0; i < 100; ++i)
+                s.spawn([&] {
+                    s.spawn([&] { ++children; });
+                    ++children;
+                });
+        }, [&] { seen = children; });
+        s.wait();
+        assert(seen == 200);
+
+        // Large and move-only tasks.
+        std::array<long, 32> big = {{1}};
+        std::unique_ptr<int> p(new int(5));
+        s.spawn([big, &n] { n += int(big[0]); });
+        s.spawn(add_owned{std::move(p), &n});
+        poly::execute(s, poly::task([&n] { ++n; }));
+        s.wait();
+        assert(n == 10007);
+
+        // The destructor waits.
+        for (int i = 0; i < 1000; ++i) s.spawn([&n] { ++n; });
+    }
+    assert(n == 11007);
+}
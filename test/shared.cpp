@@ -0,0 +1,136 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/shared.hpp>
+#include <cassert>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define POLY_TEST_FORK 1
+#endif
+
+POLY_CALLABLE(area);
+POLY_CALLABLE(scaled_area);
+
+struct shape : poly::interface<shape
+    , double(area_, poly::self const &)
+    , double(scaled_area_, poly::self, double)
+    >
+{ POLY_INTERFACE_CONSTRUCTORS(shape); };
+
+struct square { double side; };
+struct rect { float w, h; char tag; };
+
+double call(area_, square const & s) { return s.side * s.side; }
+double call(area_, rect const & r) { return double(r.w) * r.h; }
+double call(scaled_area_, square s, double k) { return k * area(shape(s)); }
+double call(scaled_area_, rect r, double k) { return k * r.w * r.h; }
+
+void register_types(poly::type_registry<shape> & types) {
+    types.add<square>();
+    types.add<rect>();
+}
+
+double total(poly::shared_collection<shape> const & c) {
+    double sum = 0;
+    for (std::size_t i = 0; i < c.size(); ++i) sum += area(c[i]);
+    return sum;
+}
+
+int main() {
+    poly::type_registry<shape> types;
+    register_types(types);
+    assert(types.size() == 2);
+    assert(types.add<square>() == 0);
+    assert(types.id<rect>() == 1);
+
+    poly::shared_builder<shape> b(types);
+    for (int i = 0; i < 100; ++i) {
+        if (i % 2) b.push_back(square{double(i)});
+        else b.push_back(rect{float(i), 2, 'r'});
+    }
+    double expected = 0;
+    for (int i = 0; i < 100; ++i)
+        expected += i % 2 ? double(i) * i : double(i) * 2;
+
+    // The block can be used at any address.
+    std::unique_ptr<std::max_align_t[]> block(new std::max_align_t[
+        b.size_bytes() / sizeof(std::max_align_t) + 1]);
+    b.write(block.get());
+    std::unique_ptr<std::max_align_t[]> moved(new std::max_align_t[
+        b.size_bytes() / sizeof(std::max_align_t) + 1]);
+    std::memcpy(moved.get(), block.get(), b.size_bytes());
+    block.reset();
+
+    poly::shared_collection<shape> c(types, moved.get());
+    assert(c.size() == 100);
+    assert(total(c) == expected);
+    assert(c[3].target<square>() && c[3].target<square>()->side == 3);
+    assert(c[4].target<rect>());
+#ifndef POLY_NO_RTTI
+    assert(c[4].type() == typeid(rect));
+#endif
+    assert(scaled_area(c[5], 2.0) == 50);
+
+#ifndef POLY_NO_EXCEPTIONS
+    bool threw = false;
+    try { c.at(100); } catch (std::out_of_range const &) { threw = true; }
+    assert(threw);
+
+    // A differently registered process can't open it.
+    poly::type_registry<shape> other;
+    other.add<rect>();
+    other.add<square>();
+    threw = false;
+    try {
+        poly::shared_collection<shape> d(other, moved.get());
+    } catch (std::invalid_argument const &) {
+        threw = true;
+    }
+    assert(threw);
+
+    // Registration is required for writing, too.
+    poly::type_registry<shape> empty;
+    poly::shared_builder<shape> e(empty);
+    threw = false;
+    try { e.push_back(square{1}); } catch (poly::bad_cast const &) {
+        threw = true;
+    }
+    assert(threw);
+#endif
+
+#ifdef POLY_TEST_FORK
+    // A child process reads the collection from shared memory, with a
+    // registry of its own, and reports the result through the same mapping.
+    std::size_t n = 2 * sizeof(double) + b.size_bytes();
+    void * m = mmap(nullptr, n, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    assert(m != MAP_FAILED);
+    double * result = static_cast<double *>(m);
+    void * shm = result + 2;
+    b.write(shm);
+    *result = 0;
+
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if (pid == 0) {
+        poly::type_registry<shape> child_types;
+        register_types(child_types);
+        poly::shared_collection<shape> s(child_types, shm);
+        *result = total(s);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    assert(*result == expected);
+    munmap(m, n);
+#endif
+}
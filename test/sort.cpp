@@ -0,0 +1,113 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/sort.hpp>
+#include <poly/interface.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cstdlib>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace ns {
+
+POLY_CALLABLE(value);
+POLY_CALLABLE(name);
+POLY_CALLABLE(serial);
+
+struct number : poly::interface<number
+    , double(value_, poly::self const &)
+    , std::string(name_, poly::self const &)
+    , int(serial_, poly::self const &)
+    > { POLY_INTERFACE_CONSTRUCTORS(number); };
+
+struct integer { int n, id; };
+struct real { double x; int id; };
+
+double call(value_, integer const & i) { return i.n; }
+double call(value_, real const & r) { return r.x; }
+std::string call(name_, integer const & i) { return std::to_string(i.n); }
+std::string call(name_, real const &) { return "real"; }
+int call(serial_, integer const & i) { return i.id; }
+int call(serial_, real const & r) { return r.id; }
+
+enum class level : signed char { low = -1, mid = 0, high = 1 };
+
+} // ns
+
+int main() {
+    using ns::number;
+
+    // Mixed types, sorted stably by a floating point key.
+    std::vector<number> xs;
+    for (int i = 0; i < 1000; ++i) {
+        int const r = std::rand() % 200 - 100;
+        if (i % 3) xs.push_back(ns::integer{r, i});
+        else xs.push_back(ns::real{r + 0.5, i});
+    }
+    xs.push_back(ns::real{-0.0, 1000});
+    xs.push_back(ns::integer{0, 1001});
+    xs.push_back(ns::real{0.0, 1002});
+    poly::sort_by_key(xs, ns::value);
+    for (std::size_t i = 1; i < xs.size(); ++i) {
+        double const a = ns::value(xs[i - 1]), b = ns::value(xs[i]);
+        assert(a <= b);
+        if (a == b) assert(ns::serial(xs[i - 1]) < ns::serial(xs[i]));
+    }
+
+    // Lower bounds and partitions.
+    auto lb = poly::lower_bound_by_key(xs, 0.0, ns::value);
+    assert(lb != xs.begin() && ns::value(lb[-1]) < 0 && ns::value(*lb) == 0);
+    assert(ns::serial(lb[0]) < ns::serial(lb[1]));
+    assert(poly::lower_bound_by_key(xs, 1e9, ns::value) == xs.end());
+    assert(poly::lower_bound_by_key(xs, -1e9, ns::value) == xs.begin());
+
+    auto by_serial = [](number const & x) { return ns::serial(x); };
+    poly::sort_by_key(xs, by_serial);
+    for (int i = 0; i < int(xs.size()); ++i) assert(ns::serial(xs[i]) == i);
+    auto p = poly::partition_by_key(xs, 0.5, ns::value);
+    for (auto i = xs.begin(); i != p; ++i) assert(ns::value(*i) < 0.5);
+    for (auto i = p; i != xs.end(); ++i) assert(ns::value(*i) >= 0.5);
+    for (auto i = xs.begin() + 1; i != xs.end(); ++i) {
+        if (i != p) assert(ns::serial(i[-1]) < ns::serial(*i));
+    }
+
+    // Keys sorted by comparison.
+    poly::sort_by_key(xs, by_serial);
+    poly::sort_by_key(xs, ns::name);
+    for (std::size_t i = 1; i < xs.size(); ++i) {
+        std::string const a = ns::name(xs[i - 1]), b = ns::name(xs[i]);
+        assert(a <= b);
+        if (a == b) assert(ns::serial(xs[i - 1]) < ns::serial(xs[i]));
+    }
+    auto real = poly::lower_bound_by_key(xs, std::string("real"), ns::name);
+    assert(real != xs.end() && ns::name(*real) == "real");
+
+    // Signed, unsigned, enumeration and boolean keys.
+    long long const lo = std::numeric_limits<long long>::min();
+    long long const hi = std::numeric_limits<long long>::max();
+    std::vector<long long> ls = {5, -3, 0, lo, hi, -1};
+    poly::sort_by_key(ls, [](long long x) { return x; });
+    assert(std::is_sorted(ls.begin(), ls.end()));
+    std::vector<unsigned> us = {300, 2, 70000, 1, 0};
+    poly::sort_by_key(us, [](unsigned x) { return x; });
+    assert(std::is_sorted(us.begin(), us.end()));
+    std::vector<ns::level> es = {ns::level::high, ns::level::low,
+                                 ns::level::mid, ns::level::low};
+    poly::sort_by_key(es, [](ns::level x) { return x; });
+    assert(es[0] == ns::level::low && es[1] == ns::level::low);
+    assert(es[2] == ns::level::mid && es[3] == ns::level::high);
+    std::vector<float> fs = {1.5f, -2.f, 0.f, -0.5f, 1e30f, -1e30f};
+    poly::sort_by_key(fs, [](float x) { return x; });
+    assert(std::is_sorted(fs.begin(), fs.end()));
+    std::vector<int> bs = {1, 2, 3, 4, 5, 6};
+    poly::sort_by_key(bs, [](int x) { return x % 2 == 0; });
+    assert((bs == std::vector<int>{1, 3, 5, 2, 4, 6}));
+
+    std::vector<number> empty;
+    poly::sort_by_key(empty, ns::value);
+    assert(poly::partition_by_key(empty, 0.0, ns::value) == empty.end());
+}
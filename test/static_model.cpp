@@ -0,0 +1,82 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/static_model.hpp>
+#include <poly/interface.hpp>
+#include "count_allocations.hpp"
+#include <cassert>
+#include <string>
+#include <vector>
+
+namespace ns {
+
+POLY_CALLABLE(route);
+POLY_CALLABLE(rotate);
+
+struct router : poly::interface<router
+    , int(route_, poly::self const &, int)
+    , void(rotate_, poly::self &)
+    > { POLY_INTERFACE_CONSTRUCTORS(router); };
+
+struct modulo {
+    static int destroyed;
+    explicit modulo(int n) : n(n) {}
+    modulo(modulo const &) = default;
+    ~modulo() { ++destroyed; }
+    int n;
+};
+int modulo::destroyed = 0;
+
+int call(route_, modulo const & m, int key) { return key % m.n; }
+void call(rotate_, modulo & m) { ++m.n; }
+
+} // ns
+
+static poly::static_model<ns::router, ns::modulo> const by_three(3);
+
+int main() {
+    using ns::modulo;
+    using ns::router;
+
+    assert(by_three.value().n == 3);
+
+    std::vector<router> routers;
+    routers.reserve(10);
+    std::size_t const before = allocations;
+    {
+        router r = by_three;
+        router s = r;
+        router t = std::move(s);
+        routers.assign(10, t);
+        assert(ns::route(r, 7) == 1 && ns::route(t, 8) == 2);
+        assert(poly::cast<modulo>(&static_cast<router const &>(r))->n == 3);
+    }
+    assert(allocations == before);
+    assert(modulo::destroyed == 0);
+
+    // Modifying a value gives it a copy of its own first.
+    ns::rotate(routers[0]);
+    assert(allocations == before + 1);
+    ns::rotate(routers[0]);
+    assert(allocations == before + 1);
+    assert(ns::route(routers[0], 7) == 2);
+    assert(ns::route(routers[1], 7) == 1);
+    assert(by_three.value().n == 3);
+
+    routers[2] = modulo(7);
+    assert(ns::route(routers[2], 8) == 1);
+    poly::cast<modulo>(&routers[3])->n = 4;
+    assert(ns::route(routers[3], 7) == 3);
+    assert(by_three.value().n == 3);
+
+    // Assigning a static model only makes the value refer to it.
+    std::size_t const assigning = allocations;
+    routers[2] = by_three;
+    assert(allocations == assigning);
+    assert(ns::route(routers[2], 8) == 2);
+
+    routers.clear();
+    assert(by_three.value().n == 3);
+}
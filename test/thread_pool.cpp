@@ -0,0 +1,22 @@
+// Copyright 2012 Pyry Jahkola.
+//
+// Distributed under the Boost Software License, Version 1.0. (See accompanying
+// file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <poly/thread_pool.hpp>
+#include <atomic>
+#include <cassert>
+
+int main() {
+    std::atomic<int> n(0);
+    {
+        poly::thread_pool pool(3);
+        assert(pool.size() == 3);
+        for (int i = 0; i < 1000; ++i) poly::execute(pool, [&n] { ++n; });
+    }
+    assert(n == 1000);
+
+    poly::inline_executor now;
+    poly::execute(now, [&n] { n = 0; });
+    assert(n == 0);
+}